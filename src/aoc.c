@@ -0,0 +1,48 @@
+// A multi-call binary containing every solver. The solver to run is named by
+// argv[0], so that a link to this binary called day01 behaves like day01, or
+// else by argv[1], as in `aoc day01 < input`. The solver receives the
+// remaining arguments, with its own name as argv[0].
+//
+// Each solver is compiled with -DMULTICALL=dayNN_main, which replaces its
+// _start with a function of that name, and with every other symbol made local
+// so that their copies of the utility headers don't collide. The Makefile
+// lists the solvers in SOLVERS as X(day01) X(day02) and so on.
+
+#include "util/die.h"
+#include "util/strcmp.h"
+
+#define X(day) __attribute__((noreturn)) void day##_main(int, char**);
+SOLVERS
+#undef X
+
+struct solver {
+  const char* name;
+  __attribute__((noreturn)) void (*main)(int, char**);
+};
+
+static const struct solver solvers[] = {
+#define X(day) {#day, day##_main},
+  SOLVERS
+#undef X
+};
+
+static const char* basename(const char* path) {
+  const char* name = path;
+  for (const char* i = path; *i; i++) {
+    if (*i == '/') name = i + 1;
+  }
+  return name;
+}
+
+int main(int argc, char** argv) {
+  if (argc && strcmp(basename(argv[0]), "aoc") == 0) {
+    argc--;
+    argv++;
+  }
+  if (argc == 0) die("usage: aoc <day> [args...]");
+  const char* const name = basename(argv[0]);
+  for (size_t i = 0; i < sizeof(solvers) / sizeof(solvers[0]); i++) {
+    if (strcmp(name, solvers[i].name) == 0) solvers[i].main(argc, argv);
+  }
+  die("no such solver");
+}
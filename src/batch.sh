@@ -0,0 +1,29 @@
+#!/bin/bash
+
+# Usage: src/batch.sh <solver> <inputs...>
+#
+# Run a solver built with -DBATCH (see src/util/batch.h) on every input in a
+# single process. The output for each NAME.input is written to
+# <solver>.NAME.output, and the exit status of each run is printed.
+
+set -e
+export LC_ALL=C
+
+solver="$1"
+shift
+
+for input in "$@"; do
+  printf '%d\n' "$(wc -c < "${input}")"
+  cat "${input}"
+done | "${solver}" | {
+  for input in "$@"; do
+    name="$(basename "${input}" .input)"
+    if ! read -r status length; then
+      echo "${solver}: no output for ${name}" >&2
+      exit 1
+    fi
+    IFS= read -r -N "${length}" output || true
+    printf '%s' "${output}" > "${solver}.${name}.output"
+    echo "${name} ${status}"
+  done
+}
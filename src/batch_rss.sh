@@ -0,0 +1,53 @@
+#!/bin/bash
+
+# Usage: src/batch_rss.sh <solver> <input> <records> [args...]
+#
+# Check that a solver built with -DBATCH (see src/util/batch.h) releases the
+# memory of each record before it runs the next. The solver is run on a batch
+# holding one copy of the input and then on one holding many, and its peak RSS
+# must be about the same for both.
+
+export LC_ALL=C
+
+solver="$1"
+input="$2"
+records="$3"
+shift 3
+args=("$@")
+
+# How much the peak RSS may grow with the extra records, in KiB.
+slack_kib=1024
+
+# Write a batch of $1 copies of the input to the file $2.
+frame() {
+  local bytes
+  bytes="$(wc -c < "${input}")"
+  for ((i = 0; i < $1; i++)); do
+    printf '%d\n' "${bytes}"
+    cat "${input}"
+  done > "$2"
+}
+
+# Print the peak RSS of the solver on the batch in the file $1, in KiB.
+peak_rss() {
+  local min median p95 rss
+  read -r min median p95 rss <<< \
+      "$(bin/bench/run 1 0 0 "$1" "${solver}" "${args[@]}")"
+  echo "${rss}"
+}
+
+batch="${input%.input}"
+frame 1 "${batch}.1.batch"
+frame "${records}" "${batch}.${records}.batch"
+one="$(peak_rss "${batch}.1.batch")"
+many="$(peak_rss "${batch}.${records}.batch")"
+rm -f "${batch}.1.batch" "${batch}.${records}.batch"
+
+printf '%s(rss).. ' "$(basename "${solver}")"
+if [[ -n "${one}" && -n "${many}" ]] && (( many <= one + slack_kib )); then
+  printf ' \x1b[32mPASSED\x1b[0m\n'
+else
+  printf ' \x1b[31mFAILED\x1b[0m: '
+  printf 'peak RSS %s KiB for 1 record, %s KiB for %s\n' \
+         "${one}" "${many}" "${records}"
+fi
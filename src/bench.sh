@@ -0,0 +1,170 @@
+#!/bin/bash
+
+# Usage:
+#   src/bench.sh run [results]
+#       Time every solver on each of its puzzle inputs which has an expected
+#       output and write the results (default bench/results.csv).
+#   src/bench.sh compare [baseline] [results]
+#       Compare results (default bench/results.csv) with a baseline (default
+#       bench/baseline.csv) and fail if any solver has become slower. Runs are
+#       compared by their minimum time, since that is the one least disturbed
+#       by whatever else the machine is doing.
+#   src/bench.sh scale [results]
+#       Time the solvers which have a generator in src/gen on generated inputs
+#       of increasing size, check their output against the generator's, write
+#       the throughput for each size (default bench/scaling.csv) and plot it.
+#       Generated inputs are kept in build/gen.
+#
+# Environment variables:
+#   FLAVOR     Which build to time (default opt).
+#   RUNS       Timed runs per input (default 10, or 3 for scale).
+#   WARMUP     Untimed runs per input before timing (default 2).
+#   CPU        The CPU to pin the solvers to (default 0).
+#   THRESHOLD  The percentage by which the minimum time may grow before it is
+#              considered a regression (default 10).
+#   SLACK_US   Growth of the minimum time up to this many microseconds is
+#              ignored, since it is within the noise for short runs (default
+#              500).
+
+set -e
+
+flavor="${FLAVOR:-opt}"
+runs="${RUNS:-10}"
+warmup="${WARMUP:-2}"
+cpu="${CPU:-0}"
+threshold="${THRESHOLD:-10}"
+slack_us="${SLACK_US:-500}"
+
+header="solver,input,min_us,median_us,p95_us,max_rss_kib"
+
+# Generated input sizes for each day, in the units of its generator.
+declare -A scale_sizes=(
+  [day01]="1000 10000 100000 1000000"
+  [day02]="10000 100000 1000000"
+  [day07]="1000 10000 100000"
+  [day08]="10000 100000 1000000"
+  [day11]="100 300 1000"
+)
+
+# Arguments for the solvers whose generators need them. src/gen/day01.c uses
+# a larger target than the puzzle's, so that there is room for many numbers.
+declare -A scale_args=(
+  [day01]="4000000000 2 3"
+)
+
+run() {
+  local results="${1:-bench/results.csv}"
+  mkdir -p "$(dirname "${results}")"
+  local tmp="${results}.tmp"
+  echo "${header}" > "${tmp}"
+  for solver in bin/"${flavor}"/day[0-2][0-9]; do
+    local day
+    day="$(basename "${solver}")"
+    for output in puzzles/"${day}"/*.output; do
+      local input="${output%.output}.input"
+      [[ -f "${input}" ]] || continue
+      local name
+      name="$(basename "${input}" .input)"
+      local stats
+      stats="$(bin/bench/run "${runs}" "${warmup}" "${cpu}" "${input}" \
+               "${solver}")"
+      read -r min median p95 rss <<< "${stats}"
+      printf '%s(%s).. %s us\n' "${day}" "${name}" "${median}"
+      echo "${day},${name},${min},${median},${p95},${rss}" >> "${tmp}"
+    done
+  done
+  mv "${tmp}" "${results}"
+}
+
+compare() {
+  local baseline="${1:-bench/baseline.csv}"
+  local results="${2:-bench/results.csv}"
+  if [[ ! -f "${baseline}" ]]; then
+    echo "No baseline to compare with. To make one:"
+    echo "  cp ${results} ${baseline}"
+    return
+  fi
+  awk -F, -v threshold="${threshold}" -v slack="${slack_us}" '
+    FNR == 1 { next }
+    NR == FNR { baseline[$1 "," $2] = $3; next }
+    {
+      key = $1 "," $2
+      name = $1 "(" $2 ")"
+      if (!(key in baseline)) {
+        printf "%s.. new, %d us\n", name, $3
+        next
+      }
+      before = baseline[key]
+      change = before ? 100 * ($3 - before) / before : 0
+      if ($3 > before * (1 + threshold / 100) && $3 - before > slack) {
+        printf "%s.. \x1b[31mSLOWER\x1b[0m: %d us -> %d us (%+.1f%%)\n",
+               name, before, $3, change
+        regressions++
+      } else {
+        printf "%s.. %d us -> %d us (%+.1f%%)\n", name, before, $3, change
+      }
+    }
+    END {
+      if (regressions) {
+        printf "%d regressions\n", regressions
+        exit 1
+      }
+    }' "${baseline}" "${results}"
+}
+
+scale() {
+  local results="${1:-bench/scaling.csv}"
+  local runs="${RUNS:-3}"
+  mkdir -p "$(dirname "${results}")" build/gen
+  local tmp="${results}.tmp"
+  echo "solver,size,bytes,min_us,median_us,mb_per_s" > "${tmp}"
+  for day in $(printf '%s\n' "${!scale_sizes[@]}" | sort); do
+    local solver="bin/${flavor}/${day}"
+    for size in ${scale_sizes[${day}]}; do
+      local input="build/gen/${day}.${size}.input"
+      local output="build/gen/${day}.${size}.output"
+      if [[ ! -f "${output}" ]]; then
+        bin/gen/"${day}" "${size}" 1 "${output}" > "${input}"
+      fi
+      local args=(${scale_args[${day}]})
+      if ! "${solver}" "${args[@]}" < "${input}" | cmp -s - "${output}"; then
+        echo "${day}(${size}).. wrong answer" >&2
+        exit 1
+      fi
+      local stats
+      stats="$(bin/bench/run "${runs}" "${warmup}" "${cpu}" "${input}" \
+               "${solver}" "${args[@]}")"
+      read -r min median p95 rss <<< "${stats}"
+      local bytes
+      bytes="$(wc -c < "${input}")"
+      # Bytes per microsecond is MB/s.
+      local throughput
+      throughput="$(awk -v b="${bytes}" -v t="${min}" \
+                    'BEGIN { printf "%.1f", t ? b / t : 0 }')"
+      printf '%s(%s).. %s us, %s MB/s\n' "${day}" "${size}" "${min}" \
+             "${throughput}"
+      echo "${day},${size},${bytes},${min},${median},${throughput}" >> "${tmp}"
+    done
+  done
+  mv "${tmp}" "${results}"
+  # Plot throughput against size, scaled to the fastest run of each solver.
+  awk -F, '
+    FNR == 1 { next }
+    NR == FNR { if ($6 > best[$1]) best[$1] = $6; next }
+    {
+      if ($1 != last) printf "%s\n", $1
+      last = $1
+      bar = ""
+      for (i = 0; i < int(50 * $6 / best[$1] + 0.5); i++) bar = bar "#"
+      printf "  %9d bytes |%-50s| %s MB/s\n", $3, bar, $6
+    }' "${results}" "${results}"
+}
+
+case "${1:-run}" in
+  run) run "${@:2}" ;;
+  compare) compare "${@:2}" ;;
+  scale) scale "${@:2}" ;;
+  *) echo "usage: $0 [run [results] | compare [baseline] [results] |" \
+          "scale [results]]" >&2
+     exit 1 ;;
+esac
@@ -0,0 +1,102 @@
+// Benchmark runner for src/bench.sh. Unlike the solvers, this is an ordinary
+// hosted program.
+//
+// Usage: run <runs> <warmup> <cpu> <input> <solver> [args...]
+//
+// Pins itself (and therefore the solver) to the given CPU, runs the solver with
+// the given arguments `warmup` times untimed and then `runs` times timed, each
+// time with stdin redirected from the input and stdout discarded, and prints
+// one line:
+//
+//   <min us> <median us> <p95 us> <max rss KiB>
+//
+// Exits with an error if any run of the solver fails.
+
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+static void die(const char* message) {
+  perror(message);
+  exit(1);
+}
+
+static long long now_ns(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+// Run the solver once, returning its wall time in nanoseconds and updating
+// *max_rss with its peak resident set size.
+static long long run(const char* input, char** solver, long* max_rss) {
+  const long long start = now_ns();
+  const pid_t pid = fork();
+  if (pid < 0) die("fork");
+  if (pid == 0) {
+    const int in = open(input, O_RDONLY);
+    const int out = open("/dev/null", O_WRONLY);
+    if (in < 0 || out < 0) die("open");
+    dup2(in, STDIN_FILENO);
+    dup2(out, STDOUT_FILENO);
+    execv(solver[0], solver);
+    die("exec");
+  }
+  int status;
+  struct rusage usage;
+  if (wait4(pid, &status, 0, &usage) != pid) die("wait4");
+  const long long time = now_ns() - start;
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    fprintf(stderr, "%s failed on %s\n", solver[0], input);
+    exit(1);
+  }
+  if (usage.ru_maxrss > *max_rss) *max_rss = usage.ru_maxrss;
+  return time;
+}
+
+static int compare(const void* a, const void* b) {
+  const long long x = *(const long long*)a, y = *(const long long*)b;
+  return (x > y) - (x < y);
+}
+
+int main(int argc, char** argv) {
+  if (argc < 6) {
+    fprintf(stderr,
+            "usage: %s <runs> <warmup> <cpu> <input> <solver> [args...]\n",
+            argv[0]);
+    return 1;
+  }
+  const int runs = atoi(argv[1]);
+  const int warmup = atoi(argv[2]);
+  const int cpu = atoi(argv[3]);
+  const char* const input = argv[4];
+  // The solver and its arguments, terminated by argv's null pointer.
+  char** const solver = argv + 5;
+  if (runs < 1) die("runs");
+
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(cpu, &cpus);
+  if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) die("sched_setaffinity");
+
+  long max_rss = 0;
+  for (int i = 0; i < warmup; i++) run(input, solver, &max_rss);
+  long long* const times = malloc(runs * sizeof(long long));
+  if (times == NULL) die("malloc");
+  for (int i = 0; i < runs; i++) times[i] = run(input, solver, &max_rss);
+  qsort(times, runs, sizeof(long long), compare);
+
+  // The nearest-rank percentiles.
+  const long long median = times[(runs - 1) / 2];
+  const long long p95 = times[(runs * 95 + 99) / 100 - 1];
+  printf("%lld %lld %lld %ld\n", times[0] / 1000, median / 1000, p95 / 1000,
+         max_rss);
+  free(times);
+  return 0;
+}
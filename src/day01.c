@@ -2,68 +2,222 @@
 // Part 1: Find the product of two different numbers that sum to 2020.
 // Part 2: Find the product of three different numbers that sum to 2020.
 //
-// Approach: we will optimize the brute force approach by using an array of
-// bools to model a set: set[x] is true if x is present in the array. We can now
-// perform a linear pass for part 1 (checking set[2020 - x] for each x), and
-// a quadratic search for part 2 (checking set[2020 - x - y] for each x, y).
+// Usage: day01 [target [k...]]
+//
+// More generally, this finds k different numbers which sum to a target. The
+// target defaults to 2020, and for each k given (by default 2 and then 3) the
+// product of the numbers is printed, modulo 2^64. The numbers may be anything
+// which fits in 32 bits, and the target anything up to 2^32. If several sets of
+// numbers match, the one with the smallest numbers (compared in increasing
+// order) is chosen.
+//
+// Approach: the numbers are radix sorted first, and any which exceed the target
+// are dropped. For k = 2, two cursors move inwards from either end of the
+// sorted list: if the pair sums to less than the target, the smaller number is
+// too small to be in any pair with the numbers left, and vice versa. For larger
+// k, each number in turn is tried as the smallest of the set, and the rest are
+// found by searching the numbers after it for k - 1 numbers with the remaining
+// sum. Prefix sums bound each search: once the k smallest candidates are too
+// big, no later choice can work, and a number which falls short even with the
+// k - 1 largest numbers can be skipped.
+//
+// For k = 3 with a target small enough, the numbers are also kept in a packed
+// bitset. Each pair is then checked with a single bit probe for the third
+// number, eight pairs at a time with AVX2 where the CPU has it, instead of
+// moving two cursors whose branches are hard to predict.
 
+#include "util/arena.h"
+#include "util/bitset_probe.h"
 #include "util/die.h"
-#include "util/print_int.h"
-#include "util/read_int.h"
+#include "util/map_input.h"
+#include "util/print_int64.h"
+#include "util/read_int64.h"
+#include "util/read_int_list.h"
+#include "util/trace.h"
+
+enum { default_target = 2020, max_k = 16 };
+// The largest target for which the numbers are put in a bitset (of 16 MiB).
+enum { max_bitset_target = 1 << 27 };
 
-static char buffer[1024];
-enum { max_numbers = 200 };
-// The list of input numbers.
-static unsigned numbers[max_numbers];
+// The numbers which don't exceed the target, in increasing order.
+static unsigned* numbers;
 static int n;
-// A set indexed by values from the numbers array, which is 1 iff the value is
-// in the list.
-static bool set[2021];
+// sums[i] is the sum of the first i numbers.
+static unsigned long long* sums;
+// The numbers found by the last successful search.
+static unsigned chosen[max_k];
+// A bitset of the numbers, if the target is small enough and the numbers are
+// distinct, or NULL.
+static unsigned* bits;
+
+// Sort the numbers with an LSD radix sort, 11 bits at a time. Passes in which
+// every number has the same digit are skipped, so small numbers take fewer.
+// counts[p][d] is the number of numbers with digit d in pass p.
+enum { radix_bits = 11, radix = 1 << radix_bits, passes = 3 };
+static int counts[passes][radix];
+
+static void sort_numbers(void) {
+  for (int i = 0; i < n; i++) {
+    for (int p = 0; p < passes; p++) {
+      counts[p][numbers[i] >> (p * radix_bits) & (radix - 1)]++;
+    }
+  }
+  unsigned* from = numbers;
+  unsigned* to = ARENA_RESERVE(unsigned, n);
+  for (int p = 0; p < passes; p++) {
+    const int shift = p * radix_bits;
+    if (counts[p][from[0] >> shift & (radix - 1)] == n) continue;
+    int offset = 0;
+    for (int d = 0; d < radix; d++) {
+      const int count = counts[p][d];
+      counts[p][d] = offset;
+      offset += count;
+    }
+    for (int i = 0; i < n; i++) {
+      to[counts[p][from[i] >> shift & (radix - 1)]++] = from[i];
+    }
+    unsigned* const temp = from;
+    from = to;
+    to = temp;
+  }
+  numbers = from;
+}
+
+// Returns the index of the first number in [lo, hi) which exceeds value.
+static int upper_bound(int lo, int hi, unsigned long long value) {
+  while (lo < hi) {
+    const int mid = lo + (hi - lo) / 2;
+    if (numbers[mid] <= value) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
 
-// Parse the input into `numbers` and `set`.
-static void read_input() {
-  int len = read(STDIN_FILENO, buffer, sizeof(buffer) - 1);
+// Parse the input, keeping only the numbers which could be part of a sum.
+static void read_input(unsigned long long target) {
+  int len;
+  const char* const buffer = map_input(&len);
   if (len <= 0) die("bad");
   if (buffer[len - 1] != '\n') die("bad");
-  const char* i = buffer;
+  // Each number occupies at least two bytes, including its newline.
+  numbers = ARENA_RESERVE(unsigned, len / 2);
   const char* const end = buffer + len;
-  while (i != end) {
-    if (n == max_numbers) die("too many");
-    i = read_int(i, &numbers[n]);
-    if (numbers[n] > 2020) die("too large");
-    set[numbers[n]] = true;
-    n++;
-    if (*i != '\n') die("bad");
-    i++;
+  if (read_int_list(buffer, end, '\n', numbers, len / 2, &n) != end) {
+    die("bad");
+  }
+  sort_numbers();
+  n = upper_bound(0, n, target);
+  sums = ARENA_RESERVE(unsigned long long, n + 1);
+  for (int i = 0; i < n; i++) sums[i + 1] = sums[i] + numbers[i];
+  // A bitset can't tell whether a number appears more than once.
+  if (target > max_bitset_target) return;
+  for (int i = 1; i < n; i++) {
+    if (numbers[i] == numbers[i - 1]) return;
   }
+  bits = ARENA_RESERVE(unsigned, target / 32 + 1);
+  for (int i = 0; i < n; i++) bits[numbers[i] >> 5] |= 1u << (numbers[i] & 31);
 }
 
-static int part1(void) {
-  for (int i = 0; i < n; i++) {
-    if (set[2020 - numbers[i]]) {
-      return numbers[i] * (2020 - numbers[i]);
+// Search numbers[lo..n) for two numbers which sum to target.
+static bool find_pair(int lo, unsigned long long target) {
+  if (lo >= n || numbers[lo] > target) return false;
+  int i = lo, j = upper_bound(lo, n, target - numbers[lo]) - 1;
+  while (i < j) {
+    const unsigned long long sum = (unsigned long long)numbers[i] + numbers[j];
+    if (sum == target) {
+      chosen[0] = numbers[i];
+      chosen[1] = numbers[j];
+      return true;
+    }
+    if (sum < target) {
+      i++;
+    } else {
+      j--;
     }
   }
-  die("not found");
+  return false;
 }
 
-static int part2(void) {
-  for (int i = 0; i < n; i++) {
-    unsigned remaining = 2020 - numbers[i];
-    for (int j = i + 1; j < n; j++) {
-      // Ensure that the value will be within the bounds of the set array.
-      if (numbers[j] > remaining) continue;
-      const unsigned num_k = remaining - numbers[j];
-      if (set[num_k]) {
-        return numbers[i] * numbers[j] * num_k;
-      }
+// As find_sum for k = 3, but probing the bitset for the third number.
+static bool find_triple(int lo, unsigned target) {
+  for (int i = lo; i <= n - 3; i++) {
+    if (sums[i + 3] - sums[i] > target) break;
+    const unsigned remaining = target - numbers[i];
+    // The third number must be larger than the second.
+    const int end = upper_bound(i + 1, n, (remaining - 1) / 2);
+    const int j = bitset_probe(bits, numbers, i + 1, end, remaining);
+    if (j < end) {
+      chosen[0] = numbers[j];
+      chosen[1] = remaining - numbers[j];
+      chosen[2] = numbers[i];
+      return true;
+    }
+  }
+  return false;
+}
+
+// Search numbers[lo..n) for k numbers which sum to target, storing them in
+// chosen[0..k).
+static bool find_sum(int k, int lo, unsigned long long target) {
+  if (n - lo < k) return false;
+  if (k == 1) {
+    const int i = upper_bound(lo, n, target) - 1;
+    if (i < lo || numbers[i] != target) return false;
+    chosen[0] = numbers[i];
+    return true;
+  }
+  if (k == 2) return find_pair(lo, target);
+  if (k == 3 && bits) return find_triple(lo, target);
+  // The sum of the k - 1 largest numbers, which are never before i + 1.
+  const unsigned long long largest = sums[n] - sums[n - k + 1];
+  for (int i = lo; i <= n - k; i++) {
+    if (sums[i + k] - sums[i] > target) break;
+    if (numbers[i] + largest < target) continue;
+    if (find_sum(k - 1, i + 1, target - numbers[i])) {
+      chosen[k - 1] = numbers[i];
+      return true;
     }
   }
-  die("not found");
+  return false;
+}
+
+static unsigned long long solve(int k, unsigned long long target) {
+  if (!find_sum(k, 0, target)) die("not found");
+  unsigned long long product = 1;
+  for (int i = 0; i < k; i++) product *= chosen[i];
+  return product;
 }
 
-int main() {
-  read_input();
-  print_int(part1());
-  print_int(part2());
+static unsigned long long parse_argument(const char* argument) {
+  unsigned long long value;
+  if (*read_int64(argument, &value) != '\0') die("bad argument");
+  return value;
+}
+
+int main(int argc, char** argv) {
+  const unsigned long long target =
+      argc > 1 ? parse_argument(argv[1]) : default_target;
+  if (target > 1ULL << 32) die("target too large");
+  TRACE_BEGIN("parse");
+  read_input(target);
+  TRACE_END();
+  if (argc <= 2) {
+    TRACE_BEGIN("part1");
+    print_int64(solve(2, target));
+    TRACE_END();
+    TRACE_BEGIN("part2");
+    print_int64(solve(3, target));
+    TRACE_END();
+    return 0;
+  }
+  for (int i = 2; i < argc; i++) {
+    const unsigned long long k = parse_argument(argv[i]);
+    if (k < 1 || k > max_k) die("bad k");
+    TRACE_BEGIN("search");
+    print_int64(solve(k, target));
+    TRACE_END();
+  }
 }
@@ -6,76 +6,72 @@
 // Part 2: A password is valid if char appears at exactly one of the two offsets
 // low and high. Find the number of valid passwords.
 //
-// Approach: parse the input into an array of structs for easy processing. Then,
-// the processing is pretty mechanical with no clever tricks.
+// Approach: both policies only need one record at a time, so the input is
+// streamed through a fixed buffer and nothing is stored per record. Each record
+// is checked in a single pass: the bounds and the character are parsed, and
+// then the password is scanned once, counting the character and looking for
+// the newline at the same time, a vector at a time (see util/count_line.h).
+// Memory use is constant however long the input is. A record which is cut off
+// by the end of the buffer is abandoned and parsed again from the start once
+// the buffer has been refilled.
 
+#include "util/count_line.h"
 #include "util/die.h"
-#include "util/print_int.h"
-#include "util/read_int.h"
-#include "util/strlen.h"
+#include "util/input.h"
+#include "util/is_digit.h"
+#include "util/print_int64.h"
+#include "util/trace.h"
 
-static char buffer[65536];
+static struct input input;
+static unsigned long long part1, part2;
 
-struct entry {
-  unsigned char min, max;
-  char c;
-  const char* password;
-};
-
-enum { max_entries = 1000 };
-static struct entry entries[max_entries];
-static int num_entries;
-
-static int part1(void) {
-  int total = 0;
-  for (int i = 0; i < num_entries; i++) {
-    int count = 0;
-    for (const char* j = entries[i].password; *j; j++) {
-      if (*j == entries[i].c) count++;
-    }
-    if (entries[i].min <= count && count <= entries[i].max) total++;
+// Read a decimal integer below 256 from [i, end) into *value. Returns the
+// address of the first byte after it, or NULL if the integer reaches the end.
+static const char* read_bound(const char* i, const char* end, unsigned* value) {
+  const char* const start = i;
+  unsigned temp = 0;
+  while (i != end && is_digit(*i)) {
+    temp = 10 * temp + (*i++ - '0');
+    if (temp > 255) die("bound");
   }
-  return total;
+  if (i == end) return NULL;
+  if (i == start) die("bound");
+  *value = temp;
+  return i;
 }
 
-static int part2(void) {
-  int total = 0;
-  for (int i = 0; i < num_entries; i++) {
-    struct entry* e = &entries[i];
-    int len = strlen(e->password);
-    if (len < e->min || len < e->max) die("bad index");
-    const bool first_matches = e->password[e->min - 1] == e->c;
-    const bool second_matches = e->password[e->max - 1] == e->c;
-    if (first_matches != second_matches) total++;
-  }
-  return total;
+// Check the record at the start of [i, end) against both policies. Returns the
+// address of the next record, or NULL if this one reaches the end.
+static const char* check_record(const char* i, const char* end) {
+  unsigned low, high;
+  if (!(i = read_bound(i, end, &low))) return NULL;
+  if (*i++ != '-') die("hyphen");
+  if (!(i = read_bound(i, end, &high))) return NULL;
+  if (end - i < 4) return NULL;
+  if (i[0] != ' ') die("space");
+  const char c = i[1];
+  if (i[2] != ':' || i[3] != ' ') die("colon");
+  i += 4;
+  const char* const password = i;
+  int count;
+  i = count_line(i, end, c, &count);
+  if (i == end) return NULL;
+  if (low == 0 || i - password < (int)high) die("bad index");
+  part1 += low <= (unsigned)count && (unsigned)count <= high;
+  part2 += (password[low - 1] == c) != (password[high - 1] == c);
+  return i + 1;
 }
 
 int main() {
-  // Parse the input into `entries`.
-  int len = read(STDIN_FILENO, buffer, sizeof(buffer) - 1);
-  if (len < 0) die("read");
-  char* i = buffer;
-  char* const end = buffer + len;
-  while (i < end) {
-    if (num_entries == max_entries) die("too many");
-    unsigned min, max;
-    i = (char*)read_int(i, &min);
-    if (i == NULL || min > 255) die("lower bound");
-    if (*i != '-') die("hyphen");
-    i = (char*)read_int(i + 1, &max);
-    if (i == NULL || min > 255) die("upper bound");
-    if (*i != ' ') die("space");
-    char c = i[1];
-    if (i[2] != ':' || i[3] != ' ') die("colon");
-    i += 4;
-    const char* password = i;
-    while (i != end && *i != '\n') i++;
-    *i = '\0';
-    entries[num_entries++] =
-        (struct entry){.min = min, .max = max, .c = c, .password = password};
-    i++;
-  }
-  print_int(part1());
-  print_int(part2());
+  TRACE_BEGIN("validate");
+  do {
+    const char* i = input.begin;
+    const char* next;
+    while ((next = check_record(i, input.end))) i = next;
+    input.begin = (char*)i;
+  } while (input_fill(&input));
+  if (input.begin != input.end) die("newline");
+  TRACE_END();
+  print_int64(part1);
+  print_int64(part2);
 }
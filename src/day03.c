@@ -5,50 +5,127 @@
 // Part 2: For each of (1, 1), (3, 1), (5, 1), (7, 1), (1, 2), repeat the
 // process and find the product of the tree counts from each one.
 //
+// Usage: day03 [dx,dy...]
+//
+// Given slopes as arguments, this prints the tree count for each of them
+// instead of the two parts.
+//
 // Approach: we can treat the X axis as (mod width) and solve the puzzle without
-// copying the pattern out multiple times. The processing requires a single pass
-// for each gradient and runs in time proportional to the height of the grid.
+// copying the pattern out multiple times. Each row is first packed into a
+// bitset, so that checking for a tree is a single bit probe. Then all of the
+// slopes are followed together in a single pass over the rows: each slope has
+// a column cursor and the next row that it lands on, and the slopes take turns
+// to advance through each block of rows while it is in cache. The map is
+// therefore read from memory once however many slopes there are, and part 1 is
+// just one of the slopes of part 2.
 
+#include "util/arena.h"
 #include "util/die.h"
+#include "util/map_input.h"
 #include "util/print_int64.h"
+#include "util/read_int.h"
+#include "util/trace.h"
+
+struct slope {
+  int dx, dy;
+  // The column to check on the next row that the slope lands on.
+  int x;
+  int next_row;
+  unsigned long long trees;
+};
+
+static int width, height;
+// The map, one bitset of words_per_row words per row, with a bit set for each
+// tree.
+static unsigned* map;
+static int words_per_row;
 
-static char buffer[65536];
-
-static unsigned int solve(int width, int height, int dx, int dy) {
-  unsigned int count = 0;
-  int x = 0;
-  const int row_stride = dy * (width + 1);
-  const int end = (width + 1) * height;
-  for (int row_start = row_stride; row_start < end; row_start += row_stride) {
-    x += dx;
-    if (x >= width) x -= width;
-    if (buffer[row_start + x] == '#') count++;
+static void read_input(void) {
+  int len;
+  const char* const buffer = map_input(&len);
+  while (width < len && buffer[width] != '\n') width++;
+  if (width == 0 || len % (width + 1)) die("bad input");
+  height = len / (width + 1);
+  words_per_row = (width + 31) / 32;
+  map = ARENA_RESERVE(unsigned, height * words_per_row);
+  const char* i = buffer;
+  for (int y = 0; y < height; y++) {
+    unsigned* const row = map + y * words_per_row;
+    for (int x = 0; x < width; x++) {
+      const char c = *i++;
+      if (c != '#' && c != '.') die("bad cell");
+      row[x >> 5] |= (unsigned)(c == '#') << (x & 31);
+    }
+    if (*i++ != '\n') die("bad row");
   }
-  return count;
 }
 
-static unsigned int part1(int width, int height) {
-  return solve(width, height, 3, 1);
+static void start(struct slope* slope, unsigned dx, unsigned dy) {
+  if (dy < 1) die("bad slope");
+  // A slope which steps past the bottom never lands on another row.
+  if (dy > (unsigned)height) dy = height;
+  slope->dx = dx % width;
+  slope->dy = dy;
+  slope->x = slope->dx;
+  slope->next_row = dy;
 }
 
-static const int cases[][2] = {{1, 1}, {3, 1}, {5, 1}, {7, 1}, {1, 2}};
-enum { num_cases = sizeof(cases) / sizeof(cases[0]) };
-static unsigned long long part2(int width, int height) {
-  unsigned long long total = 1;
-  for (int i = 0; i < num_cases; i++) {
-    total *= solve(width, height, cases[i][0], cases[i][1]);
+// Count the trees on each slope. The rows are taken a block at a time, and
+// every slope is advanced through a block while it is still in the L1 cache.
+static void solve(struct slope* slopes, int num_slopes) {
+  // 4096 rows of a map as wide as the puzzle's fill 16 KiB.
+  enum { block_rows = 4096 };
+  for (int top = 1; top < height; top += block_rows) {
+    const int bottom = height - top < block_rows ? height : top + block_rows;
+    for (int i = 0; i < num_slopes; i++) {
+      struct slope* const s = &slopes[i];
+      int x = s->x, y = s->next_row;
+      unsigned trees = 0;
+      for (; y < bottom; y += s->dy) {
+        const unsigned* const row = map + y * words_per_row;
+        trees += row[x >> 5] >> (x & 31) & 1;
+        x += s->dx;
+        if (x >= width) x -= width;
+      }
+      s->x = x;
+      s->next_row = y;
+      s->trees += trees;
+    }
   }
-  return total;
 }
 
-int main() {
-  // Read the input.
-  int len = read(STDIN_FILENO, buffer, sizeof(buffer) - 1);
-  if (len < 0) die("read");
-  int width = 0;
-  while (buffer[width] != '\n') width++;
-  if (len % (width + 1)) die("bad input");
-  const int height = len / (width + 1);
-  print_int64(part1(width, height));
-  print_int64(part2(width, height));
+static const int cases[][2] = {{1, 1}, {3, 1}, {5, 1}, {7, 1}, {1, 2}};
+enum { num_cases = sizeof(cases) / sizeof(cases[0]), part1_case = 1 };
+static struct slope puzzle_slopes[num_cases];
+
+int main(int argc, char** argv) {
+  TRACE_BEGIN("parse");
+  read_input();
+  TRACE_END();
+  if (argc > 1) {
+    const int num_slopes = argc - 1;
+    struct slope* const slopes = ARENA_RESERVE(struct slope, num_slopes);
+    for (int i = 0; i < num_slopes; i++) {
+      unsigned dx, dy;
+      const char* j = read_int(argv[i + 1], &dx);
+      if (*j != ',') die("usage: day03 [dx,dy...]");
+      if (*read_int(j + 1, &dy) != '\0') die("usage: day03 [dx,dy...]");
+      start(&slopes[i], dx, dy);
+    }
+    TRACE_BEGIN("solve");
+    solve(slopes, num_slopes);
+    TRACE_END();
+    for (int i = 0; i < num_slopes; i++) print_int64(slopes[i].trees);
+    return 0;
+  }
+  for (int i = 0; i < num_cases; i++) {
+    start(&puzzle_slopes[i], cases[i][0], cases[i][1]);
+  }
+  TRACE_BEGIN("solve");
+  solve(puzzle_slopes, num_cases);
+  TRACE_END();
+  print_int64(puzzle_slopes[part1_case].trees);
+  unsigned long long total = 1;
+  for (int i = 0; i < num_cases; i++) total *= puzzle_slopes[i].trees;
+  print_int64(total);
 }
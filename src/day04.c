@@ -21,9 +21,11 @@
 // statements.
 
 #include "util/die.h"
+#include "util/map_input.h"
 #include "util/print_int.h"
 #include "util/read_int.h"
 #include "util/is_lower.h"
+#include "util/trace.h"
 
 static bool is_whitespace(char c) {
   return c == ' ' || c == '\n';
@@ -76,7 +78,6 @@ static char* read_entry(char* i, struct entry* out) {
   return i + 1;
 }
 
-static char buffer[32768];
 
 static bool check_year(struct entry* e, unsigned min, unsigned max) {
   if (e->value_length != 4) return false;
@@ -167,15 +168,21 @@ static char* check_passport(
 }
 
 int main() {
-  int len = read(STDIN_FILENO, buffer, sizeof(buffer));
+  TRACE_BEGIN("read");
+  int len;
+  char* const buffer = map_input(&len);
   if (len <= 0) die("read");
   if (buffer[len - 1] != '\n') die("newline");
+  TRACE_END();
+  // Both parts are checked as each passport is parsed.
+  TRACE_BEGIN("solve");
   char* i = buffer;
   char* const end = buffer + len;
   struct passport_validity num_valid = {0};
   while (i < end) {
     i = check_passport(i, end, &num_valid);
   }
+  TRACE_END();
   print_int(num_valid.part1);
   print_int(num_valid.part2);
 }
@@ -20,20 +20,24 @@
 // column from the missing bit.
 
 #include "util/die.h"
+#include "util/input.h"
 #include "util/print_int.h"
+#include "util/trace.h"
 
 // Bitmask for seats. seats[row] is a full row with bit i set if column i is
 // populated by some boarding pass.
 static unsigned char seats[128] = {0};
 
+static struct input input;
+
 int main() {
+  // Part 1 is computed as the input is read.
+  TRACE_BEGIN("part1");
   int max_id = 0;
-  while (true) {
-    char code[11];
-    const int len = read(STDIN_FILENO, code, 11);
-    if (len == 0) break;
-    if (len != 11) die("read");
-    if (code[10] != '\n') die("newline");
+  const char* code;
+  int length;
+  while ((code = input_line(&input, &length))) {
+    if (length != 10) die("length");
     int row = 0, column = 0;
     for (int i = 0; i < 7; i++) row = (row << 1) | (code[i] == 'B');
     for (int i = 7; i < 10; i++) column = (column << 1) | (code[i] == 'R');
@@ -43,6 +47,8 @@ int main() {
   }
   // Part 1: print the maximum boarding pass ID.
   print_int(max_id);
+  TRACE_END();
+  TRACE_BEGIN("part2");
   // Part 2: find the id of the unpopulated seat. Some seats at the front and
   // back do not exist, so we need to disregard those.
   int start = 0;
@@ -54,6 +60,7 @@ int main() {
     for (int column = 0; column < 8; column++) {
       if (~seats[row] & (1 << column)) {
         print_int(row << 3 | column);
+        TRACE_END();
         return 0;
       }
     }
@@ -13,16 +13,21 @@
 // are set to 1 in each group and accumulate the output.
 
 #include "util/die.h"
+#include "util/map_input.h"
 #include "util/popcount.h"
 #include "util/print_int.h"
 #include "util/is_lower.h"
-
-static char input[32768];
+#include "util/trace.h"
 
 int main() {
-  const int len = read(STDIN_FILENO, input, sizeof(input));
+  TRACE_BEGIN("read");
+  int len;
+  char* const input = map_input(&len);
   if (len <= 0) die("read");
   if (input[len - 1] != '\n') die("newline");
+  TRACE_END();
+  // Both parts are counted as each group is parsed.
+  TRACE_BEGIN("solve");
   char* i = input;
   char* const end = input + len;
   int any_count = 0, all_count = 0;
@@ -49,6 +54,7 @@ int main() {
     any_count += popcount(any);
     all_count += popcount(all);
   }
+  TRACE_END();
   print_int(any_count);
   print_int(all_count);
 }
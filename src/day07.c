@@ -19,11 +19,13 @@
 // already been processed, and we additionally cache the count for each bag type
 // so that we can reuse it for subsequent calculations.
 
+#include "util/arena.h"
 #include "util/die.h"
-#include "util/memset.h"
+#include "util/map_input.h"
 #include "util/print_int.h"
 #include "util/read_int.h"
 #include "util/strcmp.h"
+#include "util/trace.h"
 
 // Consume a prefix from a string (returning the position after the prefix), or
 // return NULL on failure.
@@ -47,8 +49,10 @@ struct style {
   struct style* next;
 };
 
-enum { max_styles = 1024 };
-static struct style styles[max_styles];
+// Tables are sized from the input length. A style name takes at least 4 bytes
+// ("a b ") and each pair of nodes takes at least 9 bytes ("1 a b bag").
+static int max_styles, max_nodes;
+static struct style* styles;
 static int num_styles;
 static struct style* style_map[256];
 
@@ -80,30 +84,29 @@ static char* read_style(char* i, int* style) {
   return i;
 }
 
-static char buffer[65536];
-
 struct node {
-  short style;
+  int style;
   short count;
   struct node* next;
 };
 
-enum { max_nodes = 4096 };
-static struct node nodes[max_nodes];
+static struct node* nodes;
 static int num_nodes;
-static struct node* parents[max_styles];
-static struct node* children[max_styles];
+static struct node** parents;
+static struct node** children;
 
 // Part 1: Visit all bags that can be transitive parents of a certain bag.
-static bool visited[max_styles];
+static bool* visited;
 static void visit(int root) {
-  int stack[max_nodes] = {root};
+  // Each style is pushed at most once, when it is first visited.
+  int* const stack = ARENA_RESERVE(int, num_styles + 1);
+  stack[0] = root;
   int stack_size = 1;
   while (stack_size) {
     int x = stack[--stack_size];
     for (struct node* i = parents[x]; i != NULL; i = i->next) {
+      if (visited[i->style]) continue;
       visited[i->style] = true;
-      if (stack_size == max_nodes) die("overflow");
       stack[stack_size++] = i->style;
     }
   }
@@ -114,7 +117,7 @@ struct count {
   unsigned counted : 1;
   unsigned value : 31;
 };
-static struct count counts[max_styles];
+static struct count* counts;
 static unsigned count_children(int root) {
   if (counts[root].counted) return counts[root].value;
   unsigned total = 0;
@@ -127,9 +130,17 @@ static unsigned count_children(int root) {
 }
 
 int main() {
-  const int len = read(STDIN_FILENO, buffer, sizeof(buffer));
+  TRACE_BEGIN("parse");
+  int len;
+  char* const buffer = map_input(&len);
   if (len <= 0) die("read");
   if (buffer[len - 1] != '\n') die("newline");
+  max_styles = len / 4 + 1;
+  max_nodes = len / 4;
+  styles = ARENA_RESERVE(struct style, max_styles);
+  nodes = ARENA_RESERVE(struct node, max_nodes);
+  parents = ARENA_RESERVE(struct node*, max_styles);
+  children = ARENA_RESERVE(struct node*, max_styles);
   char* i = buffer;
   char* const end = buffer + len;
   while (i != end) {
@@ -149,7 +160,7 @@ int main() {
       int inner_style;
       i = read_style(i, &inner_style);
       i = consume(i, count == 1 ? "bag" : "bags");
-      if (num_nodes == max_nodes) die("too many");
+      if (num_nodes + 2 > max_nodes) die("too many");
       struct node* parent = &nodes[num_nodes++];
       parent->style = style;
       parent->count = count;
@@ -166,11 +177,18 @@ int main() {
     if (*i != '.') die("end");
     i += 2;
   }
+  TRACE_END();
   // Transitively discover all bags which can hold shiny gold bags.
+  TRACE_BEGIN("part1");
   const int shiny_gold = intern_style("shiny gold");
+  visited = ARENA_RESERVE(bool, num_styles);
+  counts = ARENA_RESERVE(struct count, num_styles);
   visit(shiny_gold);
   int total = 0;
-  for (int i = 0; i < max_styles; i++) total += visited[i];
+  for (int i = 0; i < num_styles; i++) total += visited[i];
   print_int(total);
+  TRACE_END();
+  TRACE_BEGIN("part2");
   print_int(count_children(shiny_gold));
+  TRACE_END();
 }
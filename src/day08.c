@@ -41,9 +41,12 @@
 // processing time is bounded by the number of instructions in the input.
 
 #include "util/die.h"
+#include "util/huge_pages.h"
+#include "util/map_input.h"
 #include "util/print_int.h"
 #include "util/read_int.h"
 #include "util/is_lower.h"
+#include "util/trace.h"
 
 enum opcode {
   nop,
@@ -62,18 +65,25 @@ struct operation {
   int argument : 27;
 };
 
-enum { max_code_size = 1 << 20 };
-static struct operation code[max_code_size];
+static struct operation* code;
+// The stack for part 2, which holds at most one more entry than the program.
+static int* stack;
 static int code_size;
 
 #define C(x) ((unsigned)(unsigned char)(x))
 #define KEY3(a, b, c) (C(a) | C(b) << 8 | C(c) << 16)
 
-static char buffer[8 << 20];
 static void read_input() {
-  int len = read(STDIN_FILENO, buffer, sizeof(buffer));
+  int len;
+  char* const buffer = map_input(&len);
   if (len <= 0) die("read");
   if (buffer[len - 1] != '\n') die("newline");
+  // The shortest instruction is "nop +0\n", 7 bytes. Jumps make the accesses to
+  // the program (and the stack, in part 2) fairly random, so large programs are
+  // backed by huge pages.
+  const int max_code_size = len / 7;
+  code = HUGE_ALLOC(struct operation, max_code_size);
+  stack = HUGE_ALLOC(int, max_code_size + 1);
   char* i = buffer;
   char* const end = buffer + len;
   while (i != end) {
@@ -140,7 +150,6 @@ static int part1() {
   return result;
 }
 
-static int stack[max_code_size];
 static bool terminates(int root) {
   if (code[root].seen) return code[root].terminates;
   stack[0] = root;
@@ -192,7 +201,13 @@ static int part2() {
 }
 
 int main() {
+  TRACE_BEGIN("parse");
   read_input();
+  TRACE_END();
+  TRACE_BEGIN("part1");
   print_int(part1());
+  TRACE_END();
+  TRACE_BEGIN("part2");
   print_int(part2());
+  TRACE_END();
 }
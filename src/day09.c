@@ -16,36 +16,36 @@
 // adjustments of the window.
 
 #include "util/die.h"
+#include "util/input.h"
 #include "util/print_int64.h"
 #include "util/read_int64.h"
+#include "util/trace.h"
 
 enum { max_numbers = 1024 };
-static char buffer[16384];
+static struct input input;
 static unsigned char prelude_size = 25;
 static unsigned long long numbers[max_numbers];
 static int num_numbers;
 
 static void read_input() {
-  const int len = read(STDIN_FILENO, buffer, sizeof(buffer));
-  if (len <= 0) die("read");
-  if (buffer[len - 1] != '\n') die("newline");
-  const char* i = buffer;
-  const char* const end = buffer + len;
+  int length;
+  const char* line = input_line(&input, &length);
+  if (line == NULL) die("read");
   // Processing for the test case: we look for `#N` on the first line. If
   // present, we use `N` as the prelude_size instead of 25.
-  if (*i == '#') {
-    i++;
+  if (*line == '#') {
     unsigned long long temp;
-    i = read_int64(i, &temp);
-    if (*i != '\n') die("syntax");
-    i++;
+    if (read_int64(line + 1, &temp) != line + length) die("syntax");
     if (temp > 25) die("prelude too big");
     prelude_size = temp;
+    line = input_line(&input, &length);
   }
-  while (i != end) {
-    i = read_int64(i, &numbers[num_numbers++]);
-    if (*i != '\n') die("line");
-    i++;
+  while (line) {
+    if (num_numbers == max_numbers) die("too many");
+    if (read_int64(line, &numbers[num_numbers++]) != line + length) {
+      die("line");
+    }
+    line = input_line(&input, &length);
   }
   if (num_numbers < prelude_size) die("too small");
 }
@@ -95,8 +95,14 @@ static unsigned long long part2(unsigned long long key) {
 }
 
 int main() {
+  TRACE_BEGIN("parse");
   read_input();
+  TRACE_END();
+  TRACE_BEGIN("part1");
   const unsigned long long key = part1();
   print_int64(key);
+  TRACE_END();
+  TRACE_BEGIN("part2");
   print_int64(part2(key));
+  TRACE_END();
 }
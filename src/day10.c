@@ -20,33 +20,33 @@
 // 3 smaller than the current one, so we can compute them from smallest to
 // largest in a single O(n) pass.
 
+#include "util/arena.h"
 #include "util/die.h"
+#include "util/map_input.h"
 #include "util/print_int64.h"
-#include "util/read_int16.h"
+#include "util/read_int_list.h"
+#include "util/trace.h"
 
-enum { max_numbers = 256 };
-static unsigned short numbers[max_numbers];
+static unsigned* numbers;
 static int num_numbers;
 
 static void read_input() {
-  char buffer[512];
-  const int len = read(STDIN_FILENO, buffer, sizeof(buffer));
+  int len;
+  const char* const buffer = map_input(&len);
   if (len <= 0) die("read");
   if (buffer[len - 1] != '\n') die("newline");
-  const char* i = buffer;
+  // Each number occupies at least two bytes, including its newline.
+  numbers = ARENA_RESERVE(unsigned, len / 2);
   const char* const end = buffer + len;
-  while (i != end) {
-    if (num_numbers == max_numbers) die("too many");
-    i = read_int16(i, &numbers[num_numbers++]);
-    if (*i != '\n') die("line");
-    i++;
+  if (read_int_list(buffer, end, '\n', numbers, len / 2, &num_numbers) != end) {
+    die("line");
   }
   for (int i = 0; i < num_numbers; i++) {
     int min = i;
     for (int j = i; j < num_numbers; j++) {
       if (numbers[j] < numbers[min]) min = j;
     }
-    unsigned short temp = numbers[i];
+    unsigned temp = numbers[i];
     numbers[i] = numbers[min];
     numbers[min] = temp;
   }
@@ -65,12 +65,14 @@ static int part1() {
   return counts[1] * counts[3];
 }
 
-static unsigned long long arrangements_buffer[3 * max_numbers + 10];
 static unsigned long long part2() {
   // arrangements[i] is the number of arrangements of adapters resulting in
   // a joltage level of i. It is offset by 2 into the buffer so that the loop
   // doesn't have to have special cases for the first few elements.
-  unsigned long long* arrangements = arrangements_buffer + 2;
+  // Since part 1 checked that consecutive numbers differ by at most 3, the
+  // largest index is at most 3 * num_numbers.
+  unsigned long long* arrangements =
+      ARENA_RESERVE(unsigned long long, 3 * num_numbers + 3) + 2;
   arrangements[0] = 1;
   for (int i = 0; i < num_numbers; i++) {
     const int x = numbers[i];
@@ -81,7 +83,13 @@ static unsigned long long part2() {
 }
 
 int main() {
+  TRACE_BEGIN("parse");
   read_input();
+  TRACE_END();
+  TRACE_BEGIN("part1");
   print_int64(part1());
+  TRACE_END();
+  TRACE_BEGIN("part2");
   print_int64(part2());
+  TRACE_END();
 }
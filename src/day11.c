@@ -14,41 +14,43 @@
 // that we don't have to linearly scan for them in each iteration, and then
 // check those positions directly when iterating.
 
+#include "util/arena.h"
 #include "util/die.h"
+#include "util/map_input.h"
 #include "util/memcpy.h"
 #include "util/print_int.h"
+#include "util/trace.h"
 
-enum { max_size = 128 };
-
-// Grid dimensions. All instances of `grid` will use this size.
-static int grid_width, grid_height;
+// Grid dimensions. Grids are stored row by row in flat arrays of grid_cells
+// cells, `stride` cells per row.
+static int grid_width, grid_height, stride, grid_cells;
 
 enum cell { floor, seat, person };
-struct grid {
-  char cells[max_size][max_size];
-};
 
-static struct grid input;
+static char* input;
 
 static void read_input() {
-  char temp[65536];
-  const int length = read(STDIN_FILENO, temp, sizeof(temp));
+  int length;
+  const char* const buffer = map_input(&length);
   if (length <= 0) die("read");
-  if (temp[length - 1] != '\n') die("newline");
-  const char* i = temp;
+  if (buffer[length - 1] != '\n') die("newline");
+  const char* i = buffer;
   while (*i != '\n') i++;
-  const int width = i - temp;
-  const int stride = width + 1;
-  if (length % stride != 0) die("shape");
-  const int height = length / stride;
+  const int width = i - buffer;
+  const int line = width + 1;
+  if (length % line != 0) die("shape");
+  const int height = length / line;
   // Move the input into the grid. Add a border of floor around the edges to
   // simplify the logic for handling them. However, to avoid having to subtract
   // one all over the place, the width and height are only increased by one even
-  // though they should be increased by two.
+  // though the stored grid is two larger in each dimension.
+  stride = width + 2;
+  grid_cells = stride * (height + 2);
+  input = ARENA_RESERVE(char, grid_cells);
   for (int y = 0; y < height; y++) {
     for (int x = 0; x < width; x++) {
-      char* out = &input.cells[y + 1][x + 1];
-      switch (temp[y * stride + x]) {
+      char* out = &input[(y + 1) * stride + x + 1];
+      switch (buffer[y * line + x]) {
         case 'L':
           *out = seat;
           break;
@@ -70,29 +72,34 @@ static void read_input() {
 // Find the number of people seated once the arrangement stabilises, given
 // a comfort threshold (the number of adjacent people which are needed for
 // someone to vacate their seat) and a function which counts adjacent people.
-static struct grid buffers[2];
+static char* buffers[2];
 static int find_seated(int comfort_threshold,
-                       int (*adjacent)(const struct grid*, int, int)) {
-  memcpy(&buffers[0], &input, sizeof(input));
+                       int (*adjacent)(const char* grid, int i)) {
+  if (!buffers[0]) {
+    buffers[0] = ARENA_RESERVE(char, grid_cells);
+    buffers[1] = ARENA_RESERVE(char, grid_cells);
+  }
+  memcpy(buffers[0], input, grid_cells);
   bool changed = true;
   // Iterate until the state does not change.
   for (int round = 0; changed; round++) {
     changed = false;
     const bool parity = round % 2;
-    const struct grid* source = &buffers[parity];
-    struct grid* const destination = &buffers[1 - parity];
+    const char* source = buffers[parity];
+    char* const destination = buffers[1 - parity];
     for (int y = 1; y < grid_height; y++) {
       for (int x = 1; x < grid_width; x++) {
-        const int a = adjacent(source, x, y);
-        const char cell = source->cells[y][x];
+        const int i = y * stride + x;
+        const int a = adjacent(source, i);
+        const char cell = source[i];
         if (cell == seat && a == 0) {
           changed = true;
-          destination->cells[y][x] = person;
+          destination[i] = person;
         } else if (cell == person && a >= comfort_threshold) {
           changed = true;
-          destination->cells[y][x] = seat;
+          destination[i] = seat;
         } else {
-          destination->cells[y][x] = source->cells[y][x];
+          destination[i] = source[i];
         }
       }
     }
@@ -100,72 +107,73 @@ static int find_seated(int comfort_threshold,
   int total = 0;
   for (int y = 1; y < grid_height; y++) {
     for (int x = 1; x < grid_width; x++) {
-      total += buffers[0].cells[y][x] == person;
+      total += buffers[0][y * stride + x] == person;
     }
   }
   return total;
 }
 
-static int part1_adjacent(const struct grid* source, int x, int y) {
+static int part1_adjacent(const char* source, int i) {
   int adjacent = 0;
   for (int dy = -1; dy <= 1; dy++) {
     for (int dx = -1; dx <= 1; dx++) {
       if (dx == 0 && dy == 0) continue;
-      adjacent += source->cells[y + dy][x + dx] == person;
+      adjacent += source[i + dy * stride + dx] == person;
     }
   }
   return adjacent;
 }
 
-// visible[y][x][i] gives the coordinates of the closest seat in direction
-// i which can be seen from position (x, y). If no seat is visible, the value is
-// {0, 0}. This doesn't need special handling since we have a border of floor
-// around the modified input grid.
-struct position { unsigned char x, y; };
-static struct position visible[max_size][max_size][8];
+// visible[i].cells[d] gives the index of the closest seat in direction d which
+// can be seen from cell i. If no seat is visible, the value is 0, which is
+// always floor since it is part of the border.
+struct sightlines {
+  int cells[8];
+};
+static struct sightlines* visible;
 
 static const signed char directions[8][2] = {
     {-1, -1}, {0, -1}, {1, -1}, {-1, 0}, {1, 0}, {-1, 1}, {0, 1},  {1, 1}};
 static void part2_init() {
+  visible = ARENA_RESERVE(struct sightlines, grid_cells);
   // Update the visibility arrays.
-  for (int i = 0; i < 4; i++) {
-    const int dx = directions[i][0], dy = directions[i][1];
+  for (int d = 0; d < 4; d++) {
+    const int offset = directions[d][1] * stride + directions[d][0];
     for (int y = 1; y < grid_height; y++) {
       for (int x = 1; x < grid_width; x++) {
-        int x2 = x + dx, y2 = y + dy;
-        const char obstruction = input.cells[y2][x2];
-        const struct position behind = visible[y2][x2][i];
-        visible[y][x][i] = obstruction ? (struct position){x2, y2} : behind;
+        const int i = y * stride + x, i2 = i + offset;
+        visible[i].cells[d] = input[i2] ? i2 : visible[i2].cells[d];
       }
     }
   }
-  for (int i = 4; i < 8; i++) {
-    const int dx = directions[i][0], dy = directions[i][1];
+  for (int d = 4; d < 8; d++) {
+    const int offset = directions[d][1] * stride + directions[d][0];
     for (int y = grid_height - 1; y >= 1; y--) {
       for (int x = grid_width - 1; x >= 1; x--) {
-        int x2 = x + dx, y2 = y + dy;
-        const char obstruction = input.cells[y2][x2];
-        const struct position behind = visible[y2][x2][i];
-        visible[y][x][i] = obstruction ? (struct position){x2, y2} : behind;
+        const int i = y * stride + x, i2 = i + offset;
+        visible[i].cells[d] = input[i2] ? i2 : visible[i2].cells[d];
       }
     }
   }
 }
 
-static int part2_adjacent(const struct grid* source, int x, int y) {
+static int part2_adjacent(const char* source, int i) {
   int adjacent = 0;
-  for (int i = 0; i < 8; i++) {
-    const struct position v = visible[y][x][i];
-    adjacent += source->cells[v.y][v.x] == person;
+  for (int d = 0; d < 8; d++) {
+    adjacent += source[visible[i].cells[d]] == person;
   }
   return adjacent;
 }
 
 int main() {
+  TRACE_BEGIN("parse");
   read_input();
-  // Part 1.
+  TRACE_END();
+  TRACE_BEGIN("part1");
   print_int(find_seated(4, part1_adjacent));
-  // Part 2.
+  TRACE_END();
+  TRACE_BEGIN("part2");
   part2_init();
   print_int(find_seated(5, part2_adjacent));
+  TRACE_END();
 }
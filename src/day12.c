@@ -15,11 +15,14 @@
 // apply is to use aliasing pointers to give three names (position, direction,
 // instruction_target) to 2 variables (boat position, offset). By varying the
 // assignment of these aliases we can solve both parts of the problem with the
-// same code.
+// same code, and both ships are moved as each line is read, so nothing is kept
+// per instruction and the input can be streamed.
 
 #include "util/die.h"
-#include "util/print_int.h"
+#include "util/input.h"
+#include "util/print_int64.h"
 #include "util/read_int16.h"
+#include "util/trace.h"
 
 enum action {
   north,
@@ -36,10 +39,6 @@ struct instruction {
   unsigned short value;
 };
 
-enum { max_instructions = 1024 };
-static struct instruction instructions[max_instructions];
-static int num_instructions;
-
 static enum action parse_action(char c) {
   switch (c) {
     case 'N': return north;
@@ -53,33 +52,26 @@ static enum action parse_action(char c) {
   }
 }
 
-static void read_input() {
-  char temp[8192];
-  const int length = read(STDIN_FILENO, temp, sizeof(temp));
-  if (length <= 0) die("read");
-  if (temp[length - 1] != '\n') die("newline");
-  const char* i = temp;
-  const char* const end = temp + length;
-  while (i != end) {
-    if (num_instructions == max_instructions) die("too many");
-    struct instruction* instruction = &instructions[num_instructions++];
-    instruction->action = parse_action(*i);
-    unsigned short value;
-    i = read_int16(i + 1, &value);
-    if (instruction->action == left || instruction->action == right) {
-      // We'll go off the grid if the angles aren't multiples of 90, and it is
-      // easier to work with the quotient anyway, so we'll assume that the
-      // angles are all 90, 180, or 270 and then divide them by 90.
-      // if (value == 0 || value >= 360 || value % 90 != 0) die("angle");
-      value /= 90;
-    }
-    instruction->value = value;
-    if (*i != '\n') die("line");
-    i++;
+static struct instruction parse_instruction(const char* line, int length) {
+  if (length == 0) die("syntax");
+  struct instruction instruction;
+  instruction.action = parse_action(*line);
+  unsigned short value;
+  if (read_int16(line + 1, &value) != line + length) die("line");
+  if (instruction.action == left || instruction.action == right) {
+    // We'll go off the grid if the angles aren't multiples of 90, and it is
+    // easier to work with the quotient anyway, so we'll assume that the
+    // angles are all 90, 180, or 270 and then divide them by 90.
+    // if (value == 0 || value >= 360 || value % 90 != 0) die("angle");
+    value /= 90;
   }
+  instruction.value = value;
+  return instruction;
 }
 
-struct vec { int x, y; };
+// Coordinates are 64-bit, so that the distances can't overflow however long
+// the input is.
+struct vec { long long x, y; };
 
 static struct vec rotate_left(unsigned char amount, struct vec v) {
   switch (amount) {
@@ -99,54 +91,61 @@ static struct vec rotate_right(unsigned char amount, struct vec v) {
   die("bug");
 }
 
-// Apply the instruction set with the given position and direction vectors. The
+// Apply an instruction with the given position and direction vectors. The
 // NESW instructions will affect the instruction_target, which should alias
 // either position or direction.
-static int travel(struct vec* position, struct vec* direction,
-                  struct vec* instruction_target) {
-  for (int i = 0; i < num_instructions; i++) {
-    switch (instructions[i].action) {
-      case north:
-        instruction_target->y -= instructions[i].value;
-        break;
-      case south:
-        instruction_target->y += instructions[i].value;
-        break;
-      case east:
-        instruction_target->x += instructions[i].value;
-        break;
-      case west:
-        instruction_target->x -= instructions[i].value;
-        break;
-      case forward:
-        position->x += direction->x * instructions[i].value;
-        position->y += direction->y * instructions[i].value;
-        break;
-      case left:
-        *direction = rotate_left(instructions[i].value, *direction);
-        break;
-      case right:
-        *direction = rotate_right(instructions[i].value, *direction);
-        break;
-    }
+static void travel(struct instruction instruction, struct vec* position,
+                   struct vec* direction, struct vec* instruction_target) {
+  switch (instruction.action) {
+    case north:
+      instruction_target->y -= instruction.value;
+      break;
+    case south:
+      instruction_target->y += instruction.value;
+      break;
+    case east:
+      instruction_target->x += instruction.value;
+      break;
+    case west:
+      instruction_target->x -= instruction.value;
+      break;
+    case forward:
+      position->x += direction->x * instruction.value;
+      position->y += direction->y * instruction.value;
+      break;
+    case left:
+      *direction = rotate_left(instruction.value, *direction);
+      break;
+    case right:
+      *direction = rotate_right(instruction.value, *direction);
+      break;
   }
-  const int x = position->x < 0 ? -position->x : position->x;
-  const int y = position->y < 0 ? -position->y : position->y;
-  return x + y;
 }
 
-static int part1() {
-  struct vec position = {0, 0}, direction = {1, 0};
-  return travel(&position, &direction, &position);
+static unsigned long long distance(struct vec position) {
+  const long long x = position.x < 0 ? -position.x : position.x;
+  const long long y = position.y < 0 ? -position.y : position.y;
+  return x + y;
 }
 
-static int part2() {
-  struct vec position = {0, 0}, waypoint = {10, -1};
-  return travel(&position, &waypoint, &waypoint);
-}
+static struct input input;
 
 int main() {
-  read_input();
-  print_int(part1());
-  print_int(part2());
+  // Both parts are simulated as each instruction is read.
+  TRACE_BEGIN("solve");
+  struct vec position1 = {0, 0}, direction = {1, 0};
+  struct vec position2 = {0, 0}, waypoint = {10, -1};
+  int length;
+  const char* line;
+  bool any = false;
+  while ((line = input_line(&input, &length))) {
+    const struct instruction instruction = parse_instruction(line, length);
+    travel(instruction, &position1, &direction, &position1);
+    travel(instruction, &position2, &waypoint, &waypoint);
+    any = true;
+  }
+  if (!any) die("read");
+  TRACE_END();
+  print_int64(distance(position1));
+  print_int64(distance(position2));
 }
@@ -20,12 +20,17 @@
 // over increasing k, and we can then update the period to be the least common
 // multiple of the bus ids seen so far (i.e. lcm(period, bus)). This converges
 // very quickly and avoids having to compute modular inverses, which is more
-// complicated.
+// complicated. Rather than dividing on every step of the search, we reduce
+// `earliest + i` and `period` modulo the bus once, using a precomputed
+// reciprocal, and then track the remainder as `earliest` advances.
 
 #include "util/die.h"
 #include "util/division.h"
+#include "util/divisor.h"
+#include "util/map_input.h"
 #include "util/print_int64.h"
 #include "util/read_int.h"
+#include "util/trace.h"
 
 // Round x up to the next multiple of k.
 static unsigned round_up(unsigned x, unsigned k) {
@@ -98,18 +103,31 @@ static unsigned long long part2(const char* input) {
     // Invariant: `earliest` is the earliest time when the first i buses arrive
     // at the right minute. `period` is the amount of time until that happens
     // again.
-    while ((earliest + i) % buses[i] != 0) earliest += period;
+    const struct divisor bus = divisor_init(buses[i]);
+    const unsigned step = divisor_mod(&bus, period);
+    unsigned remainder = divisor_mod(&bus, earliest + i);
+    while (remainder != 0) {
+      earliest += period;
+      remainder += step;
+      if (remainder >= bus.value) remainder -= bus.value;
+    }
     period = lcm(period, buses[i]);
   }
   return earliest;
 }
 
-static char buffer[256];
 int main() {
-  int length = read(STDIN_FILENO, buffer, sizeof(buffer) - 1);
+  // Each part parses the input itself.
+  TRACE_BEGIN("read");
+  int length;
+  const char* const buffer = map_input(&length);
   if (length <= 0) die("read");
   if (buffer[length - 1] != '\n') die("newline");
-  buffer[length] = '\0';
+  TRACE_END();
+  TRACE_BEGIN("part1");
   print_int64(part1(buffer));
+  TRACE_END();
+  TRACE_BEGIN("part2");
   print_int64(part2(buffer));
+  TRACE_END();
 }
@@ -39,9 +39,14 @@
 // small, we don't assign to many addresses in total and the size remains
 // manageable.
 
+#include "util/arena.h"
 #include "util/die.h"
+#include "util/huge_pages.h"
+#include "util/map_input.h"
+#include "util/popcount.h"
 #include "util/print_int64.h"
 #include "util/read_int.h"
+#include "util/trace.h"
 
 enum operation {
   mask,
@@ -53,19 +58,20 @@ struct instruction {
   unsigned long long a, b;
 };
 
-enum { max_instructions = 1024, memory_size = 65536 };
-static struct instruction instructions[max_instructions];
+enum { memory_size = 65536 };
+static struct instruction* instructions;
 static int num_instructions;
 
 static void read_input() {
-  char buffer[65536];
-  const int length = read(STDIN_FILENO, buffer, sizeof(buffer));
+  int length;
+  const char* const buffer = map_input(&length);
   if (length <= 0) die("read");
   if (buffer[length - 1] != '\n') die("newline");
+  // The shortest instruction is `mem[0] = 0\n`.
+  instructions = ARENA_RESERVE(struct instruction, length / 11);
   const char* i = buffer;
   const char* const end = buffer + length;
   while (i != end) {
-    if (num_instructions == max_instructions) die("too many");
     if (i[0] != 'm') die("bad");
     if (i[1] == 'a') {
       // mask = value
@@ -128,13 +134,15 @@ struct slot {
   unsigned long long value;
   struct slot* next;
 };
-enum { max_slots = 1 << 20, slot_map_size = 1 << 18 };
-static struct slot slots[max_slots];
+enum { max_slot_map_size = 1 << 18 };
+static struct slot* slots;
 static int num_slots;
-static struct slot* slot_map[slot_map_size];
+// A hash table of chains of slots, with a power of two number of buckets.
+static struct slot** slot_map;
+static unsigned slot_map_size;
 
 static unsigned bucket(unsigned long long address) {
-  return (address ^ (address >> 18)) % slot_map_size;
+  return (address ^ (address >> 18)) & (slot_map_size - 1);
 }
 
 static struct slot* get_slot(unsigned long long address) {
@@ -143,14 +151,41 @@ static struct slot* get_slot(unsigned long long address) {
     slot = &(*slot)->next;
   }
   if (*slot) return *slot;
-  if (num_slots == max_slots) die("too many");
   *slot = &slots[num_slots++];
   (*slot)->address = address;
   (*slot)->value = 0;
   return *slot;
 }
 
+// Returns an upper bound on the number of distinct addresses written in part 2:
+// each assignment writes 2^n addresses, where n is the number of floating bits.
+static unsigned long long count_addresses() {
+  unsigned long long total = 0;
+  int floating_bits = 0;
+  for (int i = 0; i < num_instructions; i++) {
+    const struct instruction* x = &instructions[i];
+    if (x->operation == mask) {
+      const unsigned long long floating = 0xFFFFFFFFFULL & ~x->a & ~x->b;
+      floating_bits = popcount(floating) + popcount(floating >> 32);
+      if (floating_bits > 30) die("too many");
+    } else {
+      total += 1 << floating_bits;
+    }
+  }
+  return total;
+}
+
 static unsigned long long part2() {
+  const unsigned long long max_slots = count_addresses();
+  if (max_slots > 0x7FFFFFFF / sizeof(struct slot)) die("too many");
+  // Both tables are accessed at random, so they are backed by huge pages when
+  // they are large enough. The hash table has about one bucket per slot.
+  slots = HUGE_ALLOC(struct slot, max_slots);
+  slot_map_size = 16;
+  while (slot_map_size < max_slots && slot_map_size < max_slot_map_size) {
+    slot_map_size *= 2;
+  }
+  slot_map = HUGE_ALLOC(struct slot*, slot_map_size);
   unsigned long long set_mask = 0, floating_mask = 0;
   for (int i = 0; i < num_instructions; i++) {
     switch (instructions[i].operation) {
@@ -179,7 +214,13 @@ static unsigned long long part2() {
 }
 
 int main() {
+  TRACE_BEGIN("parse");
   read_input();
+  TRACE_END();
+  TRACE_BEGIN("part1");
   print_int64(part1());
+  TRACE_END();
+  TRACE_BEGIN("part2");
   print_int64(part2());
+  TRACE_END();
 }
@@ -18,28 +18,41 @@
 // "not seen" value, the code is much slower. This is true even if I omit the
 // memset to 0 which is logically redundant.
 
+#include "util/arena.h"
 #include "util/die.h"
+#include "util/huge_pages.h"
+#include "util/map_input.h"
 #include "util/memset.h"
 #include "util/print_int.h"
-#include "util/read_int.h"
+#include "util/read_int_list.h"
+#include "util/trace.h"
 
-static unsigned spoken[30000001];
+enum { num_turns = 30000000 };
 int main() {
-  char buffer[128];
-  const int length = read(STDIN_FILENO, buffer, sizeof(buffer));
+  TRACE_BEGIN("parse");
+  int length;
+  const char* const buffer = map_input(&length);
   if (length <= 0) die("read");
   if (buffer[length - 1] != '\n') die("newline");
-  const char* i = buffer;
+  // Each number occupies at least two bytes, including its separator.
+  unsigned* const starting = ARENA_RESERVE(unsigned, length / 2);
+  int num_starting;
+  const char* const i = read_int_list(buffer, buffer + length, ',', starting,
+                                      length / 2, &num_starting);
+  if (*i != '\n') die("comma");
+  if (i + 1 != buffer + length) die("newline");
+  TRACE_END();
+  TRACE_BEGIN("part1");
   unsigned turn = 0;
-  unsigned last_number;
-  memset(spoken, -1, sizeof(spoken));
-  while (true) {
+  unsigned last_number = 0;
+  // The table is accessed at random, so it is backed by huge pages.
+  unsigned* const spoken = HUGE_ALLOC(unsigned, num_turns + 1);
+  memset(spoken, -1, (num_turns + 1) * sizeof(unsigned));
+  for (int j = 0; j < num_starting; j++) {
     ++turn;
-    i = read_int(i, &last_number);
+    last_number = starting[j];
+    if (last_number > num_turns) die("too large");
     spoken[last_number] = turn;
-    if (*i == '\n') break;
-    if (*i != ',') die("comma");
-    i++;
   }
   while (turn < 2020) {
     const unsigned answer =
@@ -49,7 +62,9 @@ int main() {
     last_number = answer;
   }
   print_int(last_number);
-  while (turn < 30000000) {
+  TRACE_END();
+  TRACE_BEGIN("part2");
+  while (turn < num_turns) {
     const unsigned answer =
         spoken[last_number] != (unsigned)-1 ? turn - spoken[last_number] : 0;
     spoken[last_number] = turn;
@@ -57,4 +72,5 @@ int main() {
     last_number = answer;
   }
   print_int(last_number);
+  TRACE_END();
 }
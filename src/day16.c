@@ -15,10 +15,13 @@
 // the relevant fields from our ticket and calculate the product.
 
 #include "util/die.h"
+#include "util/map_input.h"
 #include "util/memset.h"
+#include "util/parallel.h"
 #include "util/print_int64.h"
 #include "util/read_int16.h"
 #include "util/strncmp.h"
+#include "util/trace.h"
 
 struct range {
   unsigned short min, max;
@@ -135,13 +138,23 @@ static bool deduce_fields(signed char* result, unsigned taken) {
   return false;
 }
 
-static unsigned long long part2() {
-  // Eliminate all conflicting entries.
-  memset(valid_pairs, 1, sizeof(valid_pairs));
-  for (int i = 0; i < num_tickets; i++) {
-    if (invalid_ticket(&tickets[i])) continue;
-    // For each value index.
-    for (int j = 0; j < num_fields; j++) {
+// valid_tickets[i] is true if tickets[i] is a valid ticket.
+static bool valid_tickets[max_tickets];
+
+static void check_tickets(void* context, int begin, int end) {
+  (void)context;
+  for (int i = begin; i < end; i++) {
+    valid_tickets[i] = !invalid_ticket(&tickets[i]);
+  }
+}
+
+// Eliminate conflicting entries for value indices in the range [begin, end).
+static void eliminate_pairs(void* context, int begin, int end) {
+  (void)context;
+  // For each value index.
+  for (int j = begin; j < end; j++) {
+    for (int i = 0; i < num_tickets; i++) {
+      if (!valid_tickets[i]) continue;
       // For each field.
       for (int k = 0; k < num_fields; k++) {
         if (!valid(&fields[k], tickets[i].values[j])) {
@@ -150,6 +163,15 @@ static unsigned long long part2() {
       }
     }
   }
+}
+
+static unsigned long long part2() {
+  // Eliminate all conflicting entries. Tickets can be checked independently,
+  // and each value index has its own row in valid_pairs, so both passes can
+  // run in parallel.
+  memset(valid_pairs, 1, sizeof(valid_pairs));
+  parallel_for(0, num_tickets, 32, check_tickets, NULL);
+  parallel_for(0, num_fields, 1, eliminate_pairs, NULL);
   // indices[i] is the value index for field i.
   signed char indices[max_fields];
   memset(indices, -1, sizeof(indices));
@@ -164,8 +186,9 @@ static unsigned long long part2() {
 }
 
 int main() {
-  char buffer[32768];
-  const int length = read(STDIN_FILENO, buffer, sizeof(buffer));
+  TRACE_BEGIN("parse");
+  int length;
+  char* const buffer = map_input(&length);
   if (length <= 0) die("read");
   if (buffer[length - 1] != '\n') die("newline");
   char* i = buffer;
@@ -194,7 +217,15 @@ int main() {
   if (strncmp(i, "nearby tickets:\n", 16) != 0) die("syntax");
   i += 16;
   const char* const end = buffer + length;
-  while (i != end) i = read_ticket(i, &tickets[num_tickets++]);
+  while (i != end) {
+    if (num_tickets == max_tickets) die("too many tickets");
+    i = read_ticket(i, &tickets[num_tickets++]);
+  }
+  TRACE_END();
+  TRACE_BEGIN("part1");
   print_int64(part1());
+  TRACE_END();
+  TRACE_BEGIN("part2");
   print_int64(part2());
+  TRACE_END();
 }
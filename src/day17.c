@@ -18,20 +18,22 @@
 // access.
 
 #include "util/die.h"
+#include "util/map_input.h"
 #include "util/memset.h"
+#include "util/parallel.h"
 #include "util/print_int.h"
+#include "util/trace.h"
 
 enum { size_x = 32, size_y = 32, size_z = 16, size_w = 16 };
 static bool part1_cells[2][size_z][size_y][size_x];
 static unsigned char part2_cells[2][size_w][size_z][size_y][size_x];
 
 static void read_input() {
-  char buffer[256];
-  const int length = read(STDIN_FILENO, buffer, sizeof(buffer));
+  int length;
+  const char* const buffer = map_input(&length);
   if (length <= 0) die("read");
   if (buffer[length - 1] != '\n') die("newline");
-  buffer[length] = '\0';
-  char* i = buffer;
+  const char* i = buffer;
   while (*i != '\n') i++;
   const int width = i - buffer;
   if (length % (width + 1) != 0) die("shape");
@@ -88,29 +90,42 @@ static int part1() {
   return populated;
 }
 
-static int part2() {
-  for (int i = 0; i < 6; i++) {
-    const bool parity = i % 2;
-    unsigned char (*input)[size_z][size_y][size_x] = part2_cells[parity];
-    unsigned char (*output)[size_z][size_y][size_x] = part2_cells[1 - parity];
+// The cells that are updated directly in part 2. All other cells are either
+// border cells or are mirror images of these ones. There are `num_planes`
+// (w, z) planes which are indexed in the order (w, z).
+enum {
+  first_w = size_w / 2,
+  first_z = size_z / 2,
+  num_w = size_w - 1 - first_w,
+  num_z = size_z - 1 - first_z,
+  num_planes = num_w * num_z,
+};
+
+struct part2_step {
+  unsigned char (*input)[size_z][size_y][size_x];
+  unsigned char (*output)[size_z][size_y][size_x];
+};
+
+// Compute the next state of the (w, z) planes in the range [begin, end).
+static void part2_update(void* context, int begin, int end) {
+  const struct part2_step* step = context;
+  unsigned char (*input)[size_z][size_y][size_x] = step->input;
+  unsigned char (*output)[size_z][size_y][size_x] = step->output;
+  for (int plane = begin; plane < end; plane++) {
+    const int w = first_w + plane / num_z, z = first_z + plane % num_z;
     // Accumulate the neighbours for each cell. Instead of doing it one cell at
-    // a time, we do every cell at once, accumulating the partial totals in the
-    // output cells before replacing those neighbour counts with cell values
-    // later. This has much better cache locality as the innermost loops only
-    // access two locations that always move forwards linearly.
-    memset(output, 0, sizeof(part2_cells[1 - parity]));
+    // a time, we do a whole plane at once, accumulating the partial totals in
+    // the output cells before replacing those neighbour counts with cell
+    // values later. This has much better cache locality as the innermost loops
+    // only access two locations that always move forwards linearly.
     for (int dw = -1; dw <= 1; dw++) {
       for (int dz = -1; dz <= 1; dz++) {
         for (int dy = -1; dy <= 1; dy++) {
           for (int dx = -1; dx <= 1; dx++) {
             if (dx == 0 && dy == 0 && dz == 0 && dw == 0) continue;
-            for (int w = size_w / 2; w < size_w - 1; w++) {
-              for (int z = size_z / 2; z < size_z - 1; z++) {
-                for (int y = 1; y < size_y - 1; y++) {
-                  for (int x = 1; x < size_x - 1; x++) {
-                    output[w][z][y][x] += input[w + dw][z + dz][y + dy][x + dx];
-                  }
-                }
+            for (int y = 1; y < size_y - 1; y++) {
+              for (int x = 1; x < size_x - 1; x++) {
+                output[w][z][y][x] += input[w + dw][z + dz][y + dy][x + dx];
               }
             }
           }
@@ -119,26 +134,36 @@ static int part2() {
     }
     // Having accumulated the population counts, use them to establish the new
     // cell values.
-    for (int w = size_w / 2; w < size_w - 1; w++) {
-      for (int z = size_z / 2; z < size_z - 1; z++) {
-        for (int y = 1; y < size_y - 1; y++) {
-          for (int x = 1; x < size_x - 1; x++) {
-            const bool populated = input[w][z][y][x];
-            const unsigned char neighbours = output[w][z][y][x];
-            if (populated) {
-              output[w][z][y][x] = neighbours == 2 || neighbours == 3;
-            } else {
-              output[w][z][y][x] = neighbours == 3;
-            }
-            // Exploit the symmetry.
-            output[size_w - w][z][y][x] = output[w][z][y][x];
-            output[size_w - w][size_z - z][y][x] = output[w][z][y][x];
-            output[w][size_z - z][y][x] = output[w][z][y][x];
-          }
+    for (int y = 1; y < size_y - 1; y++) {
+      for (int x = 1; x < size_x - 1; x++) {
+        const bool populated = input[w][z][y][x];
+        const unsigned char neighbours = output[w][z][y][x];
+        if (populated) {
+          output[w][z][y][x] = neighbours == 2 || neighbours == 3;
+        } else {
+          output[w][z][y][x] = neighbours == 3;
         }
+        // Exploit the symmetry. The mirror images of each plane are never
+        // updated directly, so no two planes write to the same cells.
+        output[size_w - w][z][y][x] = output[w][z][y][x];
+        output[size_w - w][size_z - z][y][x] = output[w][z][y][x];
+        output[w][size_z - z][y][x] = output[w][z][y][x];
       }
     }
   }
+}
+
+static int part2() {
+  for (int i = 0; i < 6; i++) {
+    const bool parity = i % 2;
+    struct part2_step step = {
+      .input = part2_cells[parity],
+      .output = part2_cells[1 - parity],
+    };
+    memset(step.output, 0, sizeof(part2_cells[1 - parity]));
+    // Each plane is updated independently, so we can update them in parallel.
+    parallel_for(0, num_planes, 1, part2_update, &step);
+  }
   // Count the populated cells.
   int populated = 0;
   for (int w = 0; w < size_w; w++) {
@@ -154,7 +179,13 @@ static int part2() {
 }
 
 int main() {
+  TRACE_BEGIN("parse");
   read_input();
+  TRACE_END();
+  TRACE_BEGIN("part1");
   print_int(part1());
+  TRACE_END();
+  TRACE_BEGIN("part2");
   print_int(part2());
+  TRACE_END();
 }
@@ -10,8 +10,10 @@
 // down parser that evaluates the expression as it goes.
 
 #include "util/die.h"
+#include "util/map_input.h"
 #include "util/print_int64.h"
 #include "util/read_int64.h"
+#include "util/trace.h"
 
 static const char* part1_expr(const char* i, unsigned long long* result);
 
@@ -115,12 +117,19 @@ static unsigned long long part2(const char* i, const char* const end) {
 }
 
 int main() {
-  char buffer[32768];
-  const int length = read(STDIN_FILENO, buffer, sizeof(buffer));
+  // Each part parses the input itself.
+  TRACE_BEGIN("read");
+  int length;
+  const char* const buffer = map_input(&length);
   if (length <= 0) die("read");
   if (buffer[length - 1] != '\n') die("newline");
   const char* i = buffer;
   const char* const end = buffer + length;
+  TRACE_END();
+  TRACE_BEGIN("part1");
   print_int64(part1(i, end));
+  TRACE_END();
+  TRACE_BEGIN("part2");
   print_int64(part2(i, end));
+  TRACE_END();
 }
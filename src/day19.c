@@ -46,8 +46,11 @@
 // a success.
 
 #include "util/die.h"
+#include "util/map_input.h"
+#include "util/parallel.h"
 #include "util/print_int.h"
 #include "util/read_int.h"
+#include "util/trace.h"
 
 enum { max_parts = 3, max_sequences = 2, max_rules = 256, max_messages = 1024 };
 struct sequence {
@@ -65,13 +68,13 @@ struct rule {
   };
 };
 
-static char buffer[32768];
 static struct rule rules[max_rules];
 static const char* messages[max_messages];
 static int num_messages;
 
 static void read_input() {
-  const int length = read(STDIN_FILENO, buffer, sizeof(buffer));
+  int length;
+  char* const buffer = map_input(&length);
   if (length <= 0) die("read");
   if (buffer[length - 1] != '\n') die("newline");
   char* i = buffer;
@@ -195,9 +198,11 @@ static const char* match_end(void* data, const char* input) {
   return *input == '\0' ? input : NULL;
 }
 
-static int count_matches() {
+// Count the matching messages in the range [begin, end).
+static unsigned long long count_range(void* context, int begin, int end) {
+  (void)context;
   int count = 0;
-  for (int i = 0; i < num_messages; i++) {
+  for (int i = begin; i < end; i++) {
     const char* result = match(
         0, messages[i], (struct match_resume){.func = match_end});
     if (result && *result == '\0') count++;
@@ -205,9 +210,19 @@ static int count_matches() {
   return count;
 }
 
+static int count_matches() {
+  // Each message is matched independently, so we can match them in parallel.
+  return parallel_sum(0, num_messages, 16, count_range, NULL);
+}
+
 int main() {
+  TRACE_BEGIN("parse");
   read_input();
+  TRACE_END();
+  TRACE_BEGIN("part1");
   print_int(count_matches());
+  TRACE_END();
+  TRACE_BEGIN("part2");
   rules[8] = (struct rule){
     .num_sequences = 2,
     .sequences = {
@@ -223,4 +238,5 @@ int main() {
     },
   };
   print_int(count_matches());
+  TRACE_END();
 }
@@ -48,13 +48,16 @@
 // subtract a multiple of the sea monster size (15) from the total number of (#)
 // cells.
 
+#include "util/arena.h"
 #include "util/die.h"
+#include "util/map_input.h"
 #include "util/memcpy.h"
 #include "util/memset.h"
 #include "util/popcount.h"
 #include "util/print_int64.h"
 #include "util/read_int16.h"
 #include "util/strncmp.h"
+#include "util/trace.h"
 
 // Composable transformations:
 // +-one-+ +-rouf+ +-eno-+ +four-+ +eerht+ +-two-+ +three+ +-owt-+
@@ -82,8 +85,7 @@ struct tile {
   unsigned short cells[tile_size];
 };
 
-enum { max_tiles = 256 };
-static struct tile tiles[max_tiles];
+static struct tile* tiles;
 static int num_tiles;
 
 // Reverse the bits in an unsigned short.
@@ -105,16 +107,17 @@ static unsigned short column(const struct tile* t, int c) {
 }
 
 static void read_input() {
-  char buffer[32768];
-  const int length = read(STDIN_FILENO, buffer, sizeof(buffer));
+  int length;
+  const char* const buffer = map_input(&length);
   if (length <= 0) die("read");
   if (buffer[length - 1] != '\n') die("newline");
   const char* i = buffer;
   const char* const end = buffer + length;
+  tiles = ARENA_RESERVE(struct tile, 0);
   while (i != end) {
-    if (num_tiles == max_tiles) die("too many");
     if (strncmp(i, "Tile ", 5) != 0) die("syntax");
-    struct tile* t = &tiles[num_tiles++];
+    struct tile* t = ARENA_PUSH(struct tile);
+    num_tiles++;
     i = read_int16(i + 5, &t->id);
     if (t->id == 0) die("zero id");
     if (strncmp(i, ":\n", 2) != 0) die("syntax");
@@ -414,7 +417,13 @@ static unsigned long long part2() {
 }
 
 int main() {
+  TRACE_BEGIN("parse");
   read_input();
+  TRACE_END();
+  TRACE_BEGIN("part1");
   print_int64(part1());
+  TRACE_END();
+  TRACE_BEGIN("part2");
   print_int64(part2());
+  TRACE_END();
 }
@@ -25,14 +25,17 @@
 // all allergens.
 
 #include "util/die.h"
+#include "util/map_input.h"
 #include "util/memcpy.h"
 #include "util/memmove.h"
 #include "util/memset.h"
+#include "util/output.h"
 #include "util/popcount.h"
 #include "util/print_int.h"
 #include "util/strcmp.h"
 #include "util/strlen.h"
 #include "util/strncmp.h"
+#include "util/trace.h"
 
 // Intern a string into a collection.
 enum { max_size = 16 };
@@ -64,8 +67,8 @@ static struct food foods[max_foods];
 static int num_foods;
 
 static void read_input() {
-  char buffer[65536];
-  const int length = read(STDIN_FILENO, buffer, sizeof(buffer));
+  int length;
+  char* const buffer = map_input(&length);
   if (length <= 0) die("read");
   if (buffer[length - 1] != '\n') die("newline");
   char* i = buffer;
@@ -210,11 +213,17 @@ static void part2() {
     *o++ = ',';
   }
   *o++ = '\n';
-  write(STDOUT_FILENO, buffer, o - buffer);
+  output_write(buffer, o - buffer);
 }
 
 int main() {
+  TRACE_BEGIN("parse");
   read_input();
+  TRACE_END();
+  TRACE_BEGIN("part1");
   print_int(part1());
+  TRACE_END();
+  TRACE_BEGIN("part2");
   part2();
+  TRACE_END();
 }
@@ -33,11 +33,13 @@
 // this is impossible.
 
 #include "util/die.h"
+#include "util/map_input.h"
 #include "util/memcpy.h"
 #include "util/memmove.h"
 #include "util/print_int.h"
 #include "util/read_int8.h"
 #include "util/strncmp.h"
+#include "util/trace.h"
 
 enum { max_cards = 64 };
 struct hand {
@@ -47,8 +49,8 @@ struct hand {
 static struct hand input_hands[2];
 
 static void read_input() {
-  char buffer[1024];
-  const int length = read(STDIN_FILENO, buffer, sizeof(buffer));
+  int length;
+  const char* const buffer = map_input(&length);
   if (length <= 0) die("read");
   if (buffer[length - 1] != '\n') die("newline");
   const char* i = buffer;
@@ -207,7 +209,13 @@ static int part2() {
 }
 
 int main() {
+  TRACE_BEGIN("parse");
   read_input();
+  TRACE_END();
+  TRACE_BEGIN("part1");
   print_int(part1());
+  TRACE_END();
+  TRACE_BEGIN("part2");
   print_int(part2());
+  TRACE_END();
 }
@@ -17,7 +17,11 @@
 // the pointer to the next node.
 
 #include "util/die.h"
+#include "util/huge_pages.h"
+#include "util/map_input.h"
+#include "util/output.h"
 #include "util/print_int64.h"
+#include "util/trace.h"
 
 struct node {
   struct node* next;
@@ -59,11 +63,12 @@ static void part1(const char* input) {
     out[i] = j - nodes + '1';
   }
   out[8] = '\n';
-  write(STDOUT_FILENO, out, 9);
+  output_write(out, 9);
 }
 
-static struct node nodes[1000000];
 static void part2(const char* input) {
+  // The moves jump around the whole list, so it is backed by huge pages.
+  struct node* const nodes = HUGE_ALLOC(struct node, 1000000);
   struct node* first;
   struct node** previous = &first;
   for (int i = 0; i < 9; i++) {
@@ -88,10 +93,16 @@ static void part2(const char* input) {
 }
 
 int main() {
-  char buffer[10];
-  const int length = read(STDIN_FILENO, buffer, sizeof(buffer));
+  TRACE_BEGIN("read");
+  int length;
+  const char* const buffer = map_input(&length);
   if (length != 10) die("read");
   if (buffer[9] != '\n') die("newline");
+  TRACE_END();
+  TRACE_BEGIN("part1");
   part1(buffer);
+  TRACE_END();
+  TRACE_BEGIN("part2");
   part2(buffer);
+  TRACE_END();
 }
@@ -26,22 +26,28 @@
 // we can use a grid which is big enough that we will never hit the edges and
 // can focus only on the easy cases.
 
+#include "util/arena.h"
 #include "util/die.h"
+#include "util/map_input.h"
 #include "util/memset.h"
 #include "util/print_int.h"
+#include "util/trace.h"
 
 enum { grid_size = 256, max_chain = grid_size / 2 - 101 };
 enum direction { e, se, sw, w, nw, ne, done, flip };
 
-static unsigned char steps[32768];
+// Each step comes from at least one byte of the input, and each flip from a
+// newline, so the steps (with the final done) take at most length + 1 bytes.
+static unsigned char* steps;
 
 static void read_input() {
-  char buffer[32768];
-  const int length = read(STDIN_FILENO, buffer, sizeof(buffer));
+  int length;
+  char* const buffer = map_input(&length);
   if (length <= 0) die("read");
   if (buffer[length - 1] != '\n') die("newline");
   char* i = buffer;
   char* const end = buffer + length;
+  steps = ARENA_RESERVE(unsigned char, length + 1);
   unsigned char* o = steps;
   while (i != end) {
     int chain = 0;
@@ -158,7 +164,13 @@ static int part2() {
 }
 
 int main() {
+  TRACE_BEGIN("parse");
   read_input();
+  TRACE_END();
+  TRACE_BEGIN("part1");
   print_int(part1());
+  TRACE_END();
+  TRACE_BEGIN("part2");
   print_int(part2());
+  TRACE_END();
 }
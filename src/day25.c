@@ -26,16 +26,16 @@
 // is O(k log k).
 
 #include "util/die.h"
+#include "util/divisor.h"
+#include "util/map_input.h"
 #include "util/print_int.h"
 #include "util/read_int.h"
+#include "util/trace.h"
+
+static struct divisor modulus;
 
 static unsigned mod_mul(unsigned a, unsigned b) {
-  unsigned result = 0;
-  for (int i = 0; i < 8; i++) {
-    unsigned digits = (b >> (28 - 4 * i)) % 16;
-    result = (16 * result + digits * a) % 20201227;
-  }
-  return result;
+  return divisor_mod_mul(&modulus, a, b);
 }
 
 static unsigned mod_exp(unsigned a, unsigned b) {
@@ -108,8 +108,10 @@ static unsigned mod_log(unsigned a, unsigned b) {
 }
 
 int main() {
-  char buffer[32];
-  const int length = read(STDIN_FILENO, buffer, sizeof(buffer));
+  TRACE_BEGIN("parse");
+  modulus = divisor_init(20201227);
+  int length;
+  const char* const buffer = map_input(&length);
   if (length <= 0) die("read");
   if (buffer[length - 1] != '\n') die("newline");
   unsigned door, card;
@@ -119,8 +121,12 @@ int main() {
   i = read_int(i + 1, &card);
   if (*i != '\n') die("line");
   if (i + 1 - buffer != length) die("syntax");
+  TRACE_END();
+  // There is only one part.
+  TRACE_BEGIN("part1");
   // Find the loop size for the door.
   const unsigned loop_size = mod_log(7, door);
   // Compute the key.
   print_int(mod_exp(card, loop_size));
+  TRACE_END();
 }
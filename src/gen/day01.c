@@ -0,0 +1,91 @@
+// Generator for day01. The size is the number of values.
+//
+// The puzzle's target of 2020 leaves no room for large inputs, so the values
+// are drawn from [0, 4000000000) and the answers are for that target, as the
+// solver computes them with `day01 4000000000 2 3` (see the scale_args in
+// src/bench.sh). The range is split into one stratum per value, so that the
+// values are distinct, and then a pair and a triple which sum to the target are
+// planted so that both parts have a solution even for small sizes. Where there
+// are several solutions, the answer is the one with the smallest values, which
+// is found here by binary search over the sorted values.
+
+#include <string.h>
+
+#include "gen.h"
+
+static const uint64_t target = 4000000000;
+
+static int compare(const void* a, const void* b) {
+  const uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+  return (x > y) - (x < y);
+}
+
+// Returns whether value is in sorted[lo..n).
+static int contains(const uint32_t* sorted, long lo, long n, uint64_t value) {
+  long hi = n;
+  while (lo < hi) {
+    const long mid = lo + (hi - lo) / 2;
+    if (sorted[mid] < value) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo < n && sorted[lo] == value;
+}
+
+int main(int argc, char** argv) {
+  const char* output;
+  const long size = gen_init(argc, argv, &output);
+  if (size < 5) gen_die("size must be at least 5");
+  uint32_t* const values = malloc(size * sizeof(uint32_t));
+  uint32_t* const sorted = malloc(size * sizeof(uint32_t));
+  if (values == NULL || sorted == NULL) gen_die("malloc");
+  const uint64_t stratum = target / size;
+  // Planting can collide with another value, in which case try again.
+  while (1) {
+    for (long i = 0; i < size; i++) {
+      values[i] = i * stratum + gen_next() % stratum;
+    }
+    values[size - 1] = target - values[0];
+    values[size - 2] = target - values[1] - values[2];
+    memcpy(sorted, values, size * sizeof(uint32_t));
+    qsort(sorted, size, sizeof(uint32_t), compare);
+    long i = 1;
+    while (i < size && sorted[i] != sorted[i - 1]) i++;
+    if (i == size) break;
+  }
+  // Shuffle, so that the planted values aren't at the ends.
+  for (long i = size - 1; i > 0; i--) {
+    const long j = gen_next() % (i + 1);
+    const uint32_t temp = values[i];
+    values[i] = values[j];
+    values[j] = temp;
+  }
+  for (long i = 0; i < size; i++) printf("%u\n", values[i]);
+
+  uint64_t part1 = 0, part2 = 0;
+  int found = 0;
+  for (long i = 0; i < size && !found; i++) {
+    if (contains(sorted, i + 1, size, target - sorted[i])) {
+      part1 = sorted[i] * (target - sorted[i]);
+      found = 1;
+    }
+  }
+  found = 0;
+  for (long i = 0; i < size && !found; i++) {
+    for (long j = i + 1; j < size; j++) {
+      const uint64_t sum = (uint64_t)sorted[i] + sorted[j];
+      if (sum > target) break;
+      if (contains(sorted, j + 1, size, target - sum)) {
+        part2 = (uint64_t)sorted[i] * sorted[j] * (target - sum);
+        found = 1;
+        break;
+      }
+    }
+  }
+  gen_answer(output, "%llu\n%llu\n", (unsigned long long)part1,
+             (unsigned long long)part2);
+  free(values);
+  free(sorted);
+}
@@ -0,0 +1,27 @@
+// Generator for day02. The size is the number of password records.
+
+#include "gen.h"
+
+int main(int argc, char** argv) {
+  const char* output;
+  const long size = gen_init(argc, argv, &output);
+  long part1 = 0, part2 = 0;
+  for (long i = 0; i < size; i++) {
+    const int length = gen_range(4, 20);
+    const int low = gen_range(1, length - 1);
+    const int high = gen_range(low + 1, length);
+    const char c = gen_range('a', 'z');
+    // Bias the password towards c so that both policies pass and fail often.
+    char password[21];
+    int count = 0;
+    for (int j = 0; j < length; j++) {
+      password[j] = gen_chance(0.4) ? c : gen_range('a', 'z');
+      count += password[j] == c;
+    }
+    password[length] = '\0';
+    part1 += low <= count && count <= high;
+    part2 += (password[low - 1] == c) != (password[high - 1] == c);
+    printf("%d-%d %c: %s\n", low, high, c, password);
+  }
+  gen_answer(output, "%ld\n%ld\n", part1, part2);
+}
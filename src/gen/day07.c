@@ -0,0 +1,150 @@
+// Generator for day07. The size is the number of bag styles (and rules).
+//
+// Styles are numbered in topological order, so each style only contains styles
+// with higher numbers. Shiny gold and its descendants are the last few styles,
+// arranged in a few small layers so that part 2's answer stays small. The rest
+// form a random graph in which each style contains up to four of the next
+// hundred, and some of those just before shiny gold contain it directly. The
+// rules are printed in a random order.
+
+#include <string.h>
+
+#include "gen.h"
+
+enum {
+  max_children = 4,
+  window = 100,
+  // Styles in each layer of shiny gold's descendants, starting with itself.
+  layer0 = 1,
+  layer1 = 4,
+  layer2 = 8,
+  layer3 = 12,
+  descendants = layer0 + layer1 + layer2 + layer3,
+};
+
+struct rule {
+  int num_children;
+  int children[max_children];
+  int counts[max_children];
+};
+
+static struct rule* rules;
+static long num_styles;
+static long shiny_gold;
+
+// Style names are two words made of consonant-vowel syllables, which can't
+// form "shiny", "gold", "no" or "other".
+static void print_word(long n) {
+  static const char consonants[] = "bcdfghjklmnpqrstvwxz";
+  static const char vowels[] = "aeiou";
+  do {
+    putchar(consonants[n % 20]);
+    n /= 20;
+    putchar(vowels[n % 5]);
+    n /= 5;
+  } while (n);
+}
+
+static void print_style(long style) {
+  if (style == shiny_gold) {
+    fputs("shiny gold", stdout);
+    return;
+  }
+  print_word(style / 100);
+  putchar(' ');
+  print_word(style % 100);
+}
+
+// Add a child to a rule, unless it is already there.
+static void add_child(struct rule* rule, int child, int count) {
+  if (rule->num_children == max_children) return;
+  for (int i = 0; i < rule->num_children; i++) {
+    if (rule->children[i] == child) return;
+  }
+  rule->children[rule->num_children] = child;
+  rule->counts[rule->num_children] = count;
+  rule->num_children++;
+}
+
+int main(int argc, char** argv) {
+  const char* output;
+  num_styles = gen_init(argc, argv, &output);
+  if (num_styles < descendants + 1) gen_die("too few styles");
+  rules = calloc(num_styles, sizeof(struct rule));
+  if (rules == NULL) gen_die("calloc");
+  shiny_gold = num_styles - descendants;
+
+  // Shiny gold's descendants: each style contains one to three styles from
+  // the next layer.
+  const int layers[] = {layer0, layer1, layer2, layer3};
+  long layer_start = shiny_gold;
+  for (int l = 0; l < 3; l++) {
+    const long next_start = layer_start + layers[l];
+    for (long s = layer_start; s < next_start; s++) {
+      const int n = gen_range(1, 3);
+      for (int i = 0; i < n; i++) {
+        add_child(&rules[s], next_start + gen_range(0, layers[l + 1] - 1),
+                  gen_range(1, 5));
+      }
+    }
+    layer_start = next_start;
+  }
+
+  // Everything else.
+  for (long s = 0; s < shiny_gold; s++) {
+    const int n = gen_range(0, max_children);
+    for (int i = 0; i < n; i++) {
+      const long child = s + gen_range(1, window);
+      if (child >= num_styles) continue;
+      add_child(&rules[s], child, gen_range(1, 5));
+    }
+    if (s + window >= shiny_gold && gen_chance(0.2)) {
+      add_child(&rules[s], shiny_gold, gen_range(1, 5));
+    }
+  }
+
+  // Print the rules in a random order.
+  long* const order = malloc(num_styles * sizeof(long));
+  if (order == NULL) gen_die("malloc");
+  for (long i = 0; i < num_styles; i++) order[i] = i;
+  for (long i = num_styles - 1; i > 0; i--) {
+    const long j = gen_next() % (i + 1);
+    const long t = order[i];
+    order[i] = order[j];
+    order[j] = t;
+  }
+  for (long i = 0; i < num_styles; i++) {
+    const long s = order[i];
+    const struct rule* const rule = &rules[s];
+    print_style(s);
+    fputs(" bags contain ", stdout);
+    if (rule->num_children == 0) fputs("no other bags", stdout);
+    for (int j = 0; j < rule->num_children; j++) {
+      if (j) fputs(", ", stdout);
+      printf("%d ", rule->counts[j]);
+      print_style(rule->children[j]);
+      fputs(rule->counts[j] == 1 ? " bag" : " bags", stdout);
+    }
+    fputs(".\n", stdout);
+  }
+
+  // Part 1: styles are visited in reverse topological order, so each style's
+  // children have been resolved before it.
+  char* const contains_gold = calloc(num_styles, 1);
+  long part1 = 0;
+  for (long s = shiny_gold - 1; s >= 0; s--) {
+    for (int j = 0; j < rules[s].num_children; j++) {
+      const int child = rules[s].children[j];
+      if (child == shiny_gold || contains_gold[child]) contains_gold[s] = 1;
+    }
+    part1 += contains_gold[s];
+  }
+  // Part 2, in the same order.
+  long* const inside = calloc(num_styles, sizeof(long));
+  for (long s = num_styles - 1; s >= shiny_gold; s--) {
+    for (int j = 0; j < rules[s].num_children; j++) {
+      inside[s] += rules[s].counts[j] * (1 + inside[rules[s].children[j]]);
+    }
+  }
+  gen_answer(output, "%ld\n%ld\n", part1, inside[shiny_gold]);
+}
@@ -0,0 +1,97 @@
+// Generator for day08. The size is the number of instructions.
+//
+// The program runs straight through to a single backward jmp at position k,
+// which sends it back to an instruction that has already run. Changing that
+// jmp to a nop is the only repair: the other instructions which run before k
+// are built so that flipping them still loops forever. Each nop either has an
+// argument of 0 or a negative one (so as a jmp it lands back on the path and
+// reaches itself again), and each forward jmp skips over a `jmp +0` trap which
+// would run if it were a nop. Forward jumps before k never jump past k.
+//
+// The solver, like the puzzle, expects both answers to be positive, so the acc
+// arguments lean that way.
+
+#include "gen.h"
+
+enum opcode { acc, jmp, nop };
+
+struct instruction {
+  enum opcode opcode;
+  int argument;
+};
+
+// Run the program, returning the accumulator when an instruction is about to
+// run twice or the program ends. Sets *terminated accordingly.
+static long run(const struct instruction* code, long size, int* terminated) {
+  char* const seen = calloc(size, 1);
+  if (seen == NULL) gen_die("calloc");
+  long i = 0, accumulator = 0;
+  while (i < size && !seen[i]) {
+    seen[i] = 1;
+    switch (code[i].opcode) {
+      case acc:
+        accumulator += code[i].argument;
+        i++;
+        break;
+      case jmp:
+        i += code[i].argument;
+        break;
+      case nop:
+        i++;
+        break;
+    }
+  }
+  free(seen);
+  *terminated = i == size;
+  return accumulator;
+}
+
+int main(int argc, char** argv) {
+  const char* output;
+  const long size = gen_init(argc, argv, &output);
+  if (size < 4) gen_die("size must be at least 4");
+  struct instruction* const code = calloc(size, sizeof(struct instruction));
+  // Positions which run before the loop, for choosing jmp targets.
+  long* const path = calloc(size, sizeof(long));
+  if (code == NULL || path == NULL) gen_die("calloc");
+  long path_length = 0;
+  const long k = gen_range(size / 2, size - 2);
+  long p = 0;
+  while (p < size) {
+    if (p == k) {
+      const long target = path[gen_range(0, path_length - 1)];
+      code[p++] = (struct instruction){jmp, target - k};
+      continue;
+    }
+    if (p < k) path[path_length++] = p;
+    const long limit = p < k ? k : size;
+    const int choice = gen_range(0, 9);
+    if (choice < 2 && limit - p >= 3) {
+      // A forward jmp over a trap and some dead code.
+      const int distance = gen_range(2, limit - p < 8 ? limit - p : 8);
+      code[p] = (struct instruction){jmp, distance};
+      code[p + 1] = (struct instruction){jmp, 0};
+      for (int i = 2; i < distance; i++) {
+        code[p + i] = (struct instruction){acc, gen_range(-30, 50)};
+      }
+      p += distance;
+    } else if (choice < 4) {
+      code[p] = (struct instruction){nop, p ? -gen_range(0, p) : 0};
+      p++;
+    } else {
+      code[p++] = (struct instruction){acc, gen_range(-30, 50)};
+    }
+  }
+  static const char* const names[] = {"acc", "jmp", "nop"};
+  for (long i = 0; i < size; i++) {
+    printf("%s %+d\n", names[code[i].opcode], code[i].argument);
+  }
+  int terminated;
+  const long part1 = run(code, size, &terminated);
+  if (terminated) gen_die("program terminated");
+  code[k].opcode = nop;
+  const long part2 = run(code, size, &terminated);
+  if (!terminated) gen_die("repair failed");
+  if (part1 < 0 || part2 < 0) gen_die("negative answer; try another seed");
+  gen_answer(output, "%ld\n%ld\n", part1, part2);
+}
@@ -0,0 +1,109 @@
+// Generator for day11. The size is the side length of the (square) seat map.
+//
+// A random seat map doesn't always settle: under either set of rules, a few
+// seats can end up flipping back and forth forever. Those seats are replaced
+// with floor and the simulation is repeated until both parts settle. The map
+// is printed at the end.
+
+#include <string.h>
+
+#include "gen.h"
+
+enum cell { floor, seat, person };
+
+static long width, stride;
+static char* grid;
+static char* cells[2];
+// The cells that each cell can see, or 0 (which is always floor).
+static long (*neighbours)[8];
+
+static const int directions[8][2] = {
+    {-1, -1}, {0, -1}, {1, -1}, {-1, 0}, {1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+
+static void find_neighbours(int look) {
+  for (long y = 1; y <= width; y++) {
+    for (long x = 1; x <= width; x++) {
+      for (int d = 0; d < 8; d++) {
+        long x2 = x + directions[d][0], y2 = y + directions[d][1];
+        while (look && x2 >= 1 && x2 <= width && y2 >= 1 && y2 <= width &&
+               grid[y2 * stride + x2] == floor) {
+          x2 += directions[d][0];
+          y2 += directions[d][1];
+        }
+        const long i = y2 * stride + x2;
+        neighbours[y * stride + x][d] = grid[i] == floor ? 0 : i;
+      }
+    }
+  }
+}
+
+// Returns the number of occupied seats once the map settles, or -1 if it falls
+// into a cycle, in which case the seats which keep changing become floor.
+static long simulate(int threshold, int look) {
+  find_neighbours(look);
+  memcpy(cells[0], grid, stride * stride);
+  memcpy(cells[1], grid, stride * stride);
+  int parity = 0;
+  while (1) {
+    const char* const source = cells[parity];
+    char* const destination = cells[1 - parity];
+    // destination still holds the map from two rounds ago.
+    int changed = 0, cycled = 1;
+    for (long i = 0; i < stride * stride; i++) {
+      if (source[i] == floor) continue;
+      int n = 0;
+      for (int d = 0; d < 8; d++) n += source[neighbours[i][d]] == person;
+      char next = source[i];
+      if (source[i] == seat && n == 0) next = person;
+      if (source[i] == person && n >= threshold) next = seat;
+      changed |= next != source[i];
+      cycled &= next == destination[i];
+      destination[i] = next;
+    }
+    if (!changed) break;
+    if (cycled) {
+      for (long i = 0; i < stride * stride; i++) {
+        if (source[i] != destination[i]) grid[i] = floor;
+      }
+      return -1;
+    }
+    parity = 1 - parity;
+  }
+  long total = 0;
+  for (long i = 0; i < stride * stride; i++) total += cells[parity][i] == person;
+  return total;
+}
+
+int main(int argc, char** argv) {
+  const char* output;
+  width = gen_init(argc, argv, &output);
+  // Leave a border of floor around the grid.
+  stride = width + 2;
+  grid = calloc(stride * stride, 1);
+  cells[0] = malloc(stride * stride);
+  cells[1] = malloc(stride * stride);
+  neighbours = calloc(stride * stride, sizeof(neighbours[0]));
+  char* const line = malloc(width + 1);
+  if (grid == NULL || cells[0] == NULL || cells[1] == NULL ||
+      neighbours == NULL || line == NULL) {
+    gen_die("malloc");
+  }
+  for (long y = 1; y <= width; y++) {
+    for (long x = 1; x <= width; x++) {
+      grid[y * stride + x] = gen_chance(0.75) ? seat : floor;
+    }
+  }
+  long part1, part2;
+  do {
+    part1 = simulate(4, 0);
+    part2 = part1 < 0 ? -1 : simulate(5, 1);
+  } while (part2 < 0);
+  for (long y = 1; y <= width; y++) {
+    for (long x = 1; x <= width; x++) {
+      line[x - 1] = grid[y * stride + x] == seat ? 'L' : '.';
+    }
+    line[width] = '\n';
+    fwrite(line, 1, width + 1, stdout);
+  }
+  gen_answer(output, "%ld\n%ld\n", part1, part2);
+}
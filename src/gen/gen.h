@@ -0,0 +1,67 @@
+// Shared scaffolding for the input generators. Like src/bench/run.c, these are
+// ordinary hosted programs.
+//
+// Usage: dayNN <size> [seed] [output]
+//
+// Writes a valid input of the given size (whose unit depends on the day) to
+// stdout. The same size and seed always give the same input. If an output path
+// is given, the expected output of the solver is written there too.
+
+#pragma once
+#pragma GCC system_header
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static uint64_t gen_state;
+
+// splitmix64, which is fast and has no bad seeds.
+static uint64_t gen_next(void) {
+  uint64_t z = (gen_state += 0x9E3779B97F4A7C15);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+  return z ^ (z >> 31);
+}
+
+// Returns a uniformly random integer in [low, high].
+static int gen_range(int low, int high) {
+  return low + (int)(gen_next() % (uint64_t)(high - low + 1));
+}
+
+// Returns true with the given probability.
+static int gen_chance(double probability) {
+  return (gen_next() >> 11) * 0x1.0p-53 < probability;
+}
+
+static void gen_die(const char* message) {
+  fprintf(stderr, "%s\n", message);
+  exit(1);
+}
+
+// Parse the command line, seed the generator, and return the size.
+static long gen_init(int argc, char** argv, const char** output) {
+  if (argc < 2 || argc > 4) {
+    fprintf(stderr, "usage: %s <size> [seed] [output]\n", argv[0]);
+    exit(1);
+  }
+  const long size = atol(argv[1]);
+  if (size < 1) gen_die("bad size");
+  gen_state = argc > 2 ? strtoull(argv[2], NULL, 0) : 0;
+  *output = argc > 3 ? argv[3] : NULL;
+  return size;
+}
+
+// Write the expected output, if it was asked for.
+__attribute__((format(printf, 2, 3)))
+static void gen_answer(const char* output, const char* format, ...) {
+  if (output == NULL) return;
+  FILE* const f = fopen(output, "w");
+  if (f == NULL) gen_die("cannot open output");
+  va_list args;
+  va_start(args, format);
+  vfprintf(f, format, args);
+  va_end(args);
+  if (fclose(f) != 0) gen_die("cannot write output");
+}
@@ -0,0 +1,120 @@
+// Compare the scalar loop against the AVX2 gather kernel in bitset_probe.h, as
+// used by day01 part 2, on sorted lists of 10k and 100k values. Each row probes
+// every later value for a complement, and none is ever found (the values are
+// even and the complements odd), so every probe runs to the end of the list.
+// Before timing, the kernels are checked against each other on a copy of the
+// bitset with some complements planted in it, so that they must also agree on
+// where the first hit is.
+
+#include "microbench/microbench.h"
+#include "util/arena.h"
+#include "util/bitset_probe.h"
+#include "util/die.h"
+
+enum { target = 1 << 24, num_rows = 64 };
+
+struct search {
+  const unsigned* bits;
+  const unsigned* values;
+  int n;
+  unsigned result;
+};
+
+static void run_scalar(void* context) {
+  struct search* s = context;
+  unsigned result = 0;
+  for (int i = 0; i < num_rows; i++) {
+    result += bitset_probe_scalar(s->bits, s->values, i + 1, s->n,
+                                  target - 1 - s->values[i]);
+  }
+  s->result = result;
+}
+
+static void run_avx2(void* context) {
+  struct search* s = context;
+  unsigned result = 0;
+  for (int i = 0; i < num_rows; i++) {
+    result += bitset_probe_avx2(s->bits, s->values, i + 1, s->n,
+                                target - 1 - s->values[i]);
+  }
+  s->result = result;
+}
+
+// Fill the search with n distinct even values below target / 2, in increasing
+// order, so that every complement is odd and within the bitset.
+static void generate(struct search* s, int n) {
+  unsigned* const values = ARENA_RESERVE(unsigned, n);
+  unsigned* const bits = ARENA_RESERVE(unsigned, target / 32);
+  const unsigned stride = target / 2 / n & -2;
+  unsigned seed = n;
+  for (int i = 0; i < n; i++) {
+    seed = seed * 1103515245 + 12345;
+    values[i] = i * stride + 2 * ((seed >> 8) % (stride / 2));
+    bits[values[i] >> 5] |= 1u << (values[i] & 31);
+  }
+  s->bits = bits;
+  s->values = values;
+  s->n = n;
+}
+
+// Check that both kernels find the same first hit in every row, using a bitset
+// with a complement planted for most rows: near the start of the row, in the
+// tail which the AVX2 kernel leaves to its scalar loop, or anywhere between.
+// Another complement is planted a little after each one, often in the same
+// vector, so that a kernel must pick the first of several hits.
+static void check(const struct search* s) {
+  unsigned* const bits = ARENA_RESERVE(unsigned, target / 32);
+  for (int i = 0; i < s->n; i++) {
+    bits[s->values[i] >> 5] |= 1u << (s->values[i] & 31);
+  }
+  int planted[num_rows];
+  unsigned seed = s->n;
+  for (int i = 0; i < num_rows; i++) {
+    seed = seed * 1103515245 + 12345;
+    const int offset = (seed >> 10) % 8;
+    int j;
+    switch (seed >> 8 & 3) {
+      case 0: planted[i] = s->n; continue;
+      case 1: j = i + 1 + offset; break;
+      case 2: j = s->n - 1 - offset; break;
+      default: j = i + 1 + (seed >> 13) % (s->n - i - 1); break;
+    }
+    planted[i] = j;
+    const int later[] = {j, j + 1 + (seed >> 24) % 7};
+    for (int k = 0; k < 2 && later[k] < s->n; k++) {
+      const unsigned x = target - 1 - s->values[i] - s->values[later[k]];
+      bits[x >> 5] |= 1u << (x & 31);
+    }
+  }
+  const bool avx2 = cpu_features() & cpu_avx2;
+  for (int i = 0; i < num_rows; i++) {
+    const unsigned remaining = target - 1 - s->values[i];
+    const int expected =
+        bitset_probe_scalar(bits, s->values, i + 1, s->n, remaining);
+    // Other rows' complements may be hit first, but never a later one.
+    if (expected > planted[i]) die("scalar");
+    if (avx2 && bitset_probe_avx2(bits, s->values, i + 1, s->n, remaining) !=
+                    expected) {
+      die("avx2");
+    }
+  }
+}
+
+static void compare(int n, const char* scalar_name, const char* avx2_name) {
+  struct search s;
+  generate(&s, n);
+  check(&s);
+  const unsigned items = num_rows * (n - 1) - num_rows * (num_rows - 1) / 2;
+  run_scalar(&s);
+  if (s.result != (unsigned)num_rows * n) die("scalar");
+  microbench(scalar_name, run_scalar, &s, items);
+  if (!(cpu_features() & cpu_avx2)) return;
+  run_avx2(&s);
+  if (s.result != (unsigned)num_rows * n) die("avx2");
+  microbench(avx2_name, run_avx2, &s, items);
+}
+
+int main() {
+  compare(10000, "scalar (10k)", "avx2 (10k)");
+  compare(100000, "scalar (100k)", "avx2 (100k)");
+}
@@ -0,0 +1,90 @@
+// Compare the kernels in count_line.h, as used by day02, on 2^20 lines of
+// random lowercase passwords. With long passwords (64-191 bytes) the vector
+// loops do most of the work, and with short ones (4-19 bytes, as in the
+// puzzle) each line is a single vector or less. Times are per byte of text.
+
+#include "microbench/microbench.h"
+#include "util/arena.h"
+#include "util/count_line.h"
+#include "util/die.h"
+
+enum { num_lines = 1 << 20 };
+
+struct text {
+  const char* begin;
+  const char* end;
+  unsigned result;
+};
+
+// Count the letter 'a' + (line number mod 26) in each line.
+static void run(struct text* t,
+                const char* (*kernel)(const char*, const char*, char, int*)) {
+  unsigned total = 0;
+  int line = 0;
+  for (const char* i = t->begin; i != t->end; i++, line++) {
+    int count;
+    i = kernel(i, t->end, 'a' + line % 26, &count);
+    if (i == t->end) die("newline");
+    total += count;
+  }
+  t->result = total;
+}
+
+static void run_scalar(void* context) {
+  run(context, count_line_scalar);
+}
+
+static void run_sse2(void* context) {
+  run(context, count_line_sse2);
+}
+
+static void run_avx2(void* context) {
+  run(context, count_line_avx2);
+}
+
+// Fill the text with lines of min_length to min_length + range - 1 letters,
+// where range is a power of two.
+static void generate(struct text* t, int min_length, int range) {
+  char* const text = ARENA_RESERVE(char, num_lines * (min_length + range));
+  char* o = text;
+  unsigned seed = min_length;
+  for (int i = 0; i < num_lines; i++) {
+    seed = seed * 1103515245 + 12345;
+    const int length = min_length + (seed >> 8) % range;
+    for (int j = 0; j < length; j++) {
+      seed = seed * 1103515245 + 12345;
+      *o++ = 'a' + (seed >> 8) % 26;
+    }
+    *o++ = '\n';
+  }
+  t->begin = text;
+  t->end = o;
+}
+
+static void compare(struct text* t, const char* name) {
+  const unsigned features = cpu_features();
+  run_scalar(t);
+  const unsigned expected = t->result;
+  const unsigned bytes = t->end - t->begin;
+  printf("%s:\n", name);
+  microbench("  scalar", run_scalar, t, bytes);
+  if (!(features & cpu_popcnt)) return;
+  if (features & cpu_sse2) {
+    run_sse2(t);
+    if (t->result != expected) die("sse2");
+    microbench("  sse2", run_sse2, t, bytes);
+  }
+  if (features & cpu_avx2) {
+    run_avx2(t);
+    if (t->result != expected) die("avx2");
+    microbench("  avx2", run_avx2, t, bytes);
+  }
+}
+
+int main() {
+  struct text t;
+  generate(&t, 64, 128);
+  compare(&t, "long passwords");
+  generate(&t, 4, 16);
+  compare(&t, "short passwords");
+}
@@ -0,0 +1,132 @@
+// Compare 64-bit division strategies on the hot loops from day13 part 2 and
+// day25 mod_log:
+//   * shift_subtract - the original bit-by-bit restoring division.
+//   * udivdi3 - the current general-purpose __umoddi3 in division.h.
+//   * divisor - Barrett reduction with a precomputed reciprocal.
+//   * incremental - what day13 now does: reduce the start and the period once
+//     and then track the remainder with additions.
+// For day25, the baseline is the original mod_mul which avoided 64-bit
+// division by multiplying one nibble at a time.
+
+#include "microbench/microbench.h"
+#include "util/die.h"
+#include "util/division.h"
+#include "util/divisor.h"
+
+enum { num_steps = 1 << 20, bus = 823, modulus = 20201227 };
+
+static unsigned long long shift_subtract_mod(unsigned long long a,
+                                             unsigned long long b) {
+  unsigned long long value = b;
+  while ((value << 1) <= a) value <<= 1;
+  while (value >= b) {
+    if (value <= a) a -= value;
+    value >>= 1;
+  }
+  return a;
+}
+
+// Step through the arithmetic progression start + k * period (as day13 does
+// while searching for a departure time) and sum the remainders mod the bus.
+struct progression {
+  unsigned long long start, period;
+  unsigned long long result;
+};
+
+static void run_shift_subtract(void* context) {
+  struct progression* p = context;
+  unsigned long long x = p->start, total = 0;
+  for (int i = 0; i < num_steps; i++, x += p->period) {
+    total += shift_subtract_mod(x, bus);
+  }
+  p->result = total;
+}
+
+static void run_udivdi3(void* context) {
+  struct progression* p = context;
+  // Hide the divisor from the compiler to force a call to __umoddi3.
+  volatile unsigned long long divisor = bus;
+  const unsigned long long d = divisor;
+  unsigned long long x = p->start, total = 0;
+  for (int i = 0; i < num_steps; i++, x += p->period) total += x % d;
+  p->result = total;
+}
+
+static void run_divisor(void* context) {
+  struct progression* p = context;
+  const struct divisor d = divisor_init(bus);
+  unsigned long long x = p->start, total = 0;
+  for (int i = 0; i < num_steps; i++, x += p->period) {
+    total += divisor_mod(&d, x);
+  }
+  p->result = total;
+}
+
+static void run_incremental(void* context) {
+  struct progression* p = context;
+  const struct divisor d = divisor_init(bus);
+  const unsigned step = divisor_mod(&d, p->period);
+  unsigned remainder = divisor_mod(&d, p->start);
+  unsigned long long total = 0;
+  for (int i = 0; i < num_steps; i++) {
+    total += remainder;
+    remainder += step;
+    if (remainder >= bus) remainder -= bus;
+  }
+  p->result = total;
+}
+
+// Repeatedly multiply by a factor modulo 20201227, as day25 does while
+// searching for a discrete logarithm.
+struct chain {
+  unsigned factor;
+  unsigned result;
+};
+
+static unsigned nibble_mod_mul(unsigned a, unsigned b) {
+  unsigned result = 0;
+  for (int i = 0; i < 8; i++) {
+    unsigned digits = (b >> (28 - 4 * i)) % 16;
+    result = (16 * result + digits * a) % modulus;
+  }
+  return result;
+}
+
+static void run_nibbles(void* context) {
+  struct chain* c = context;
+  unsigned e = 1;
+  for (int i = 0; i < num_steps; i++) e = nibble_mod_mul(e, c->factor);
+  c->result = e;
+}
+
+static void run_mod_mul(void* context) {
+  struct chain* c = context;
+  const struct divisor d = divisor_init(modulus);
+  unsigned e = 1;
+  for (int i = 0; i < num_steps; i++) e = divisor_mod_mul(&d, e, c->factor);
+  c->result = e;
+}
+
+int main() {
+  struct progression p = {.start = 1068781, .period = 1000000007ULL * 7919};
+  run_shift_subtract(&p);
+  const unsigned long long expected = p.result;
+  run_udivdi3(&p);
+  if (p.result != expected) die("udivdi3");
+  run_divisor(&p);
+  if (p.result != expected) die("divisor");
+  run_incremental(&p);
+  if (p.result != expected) die("incremental");
+  microbench("day13 shift_subtract", run_shift_subtract, &p, num_steps);
+  microbench("day13 udivdi3", run_udivdi3, &p, num_steps);
+  microbench("day13 divisor", run_divisor, &p, num_steps);
+  microbench("day13 incremental", run_incremental, &p, num_steps);
+
+  struct chain c = {.factor = 16807};
+  run_nibbles(&c);
+  const unsigned expected_chain = c.result;
+  run_mod_mul(&c);
+  if (c.result != expected_chain) die("mod_mul");
+  microbench("day25 nibbles", run_nibbles, &c, num_steps);
+  microbench("day25 divisor", run_mod_mul, &c, num_steps);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+// Shared scaffolding for the microbenchmarks. Each kernel is run several times
+// and the fastest run is reported, since that is the one least disturbed by
+// whatever else the machine is doing.
+
+#include "util/gettimeofday.h"
+#include "util/strlen.h"
+#include "util/printf.h"
+
+enum { microbench_runs = 10 };
+
+// Returns the current time in microseconds.
+static unsigned long long microbench_now(void) {
+  struct timeval t;
+  gettimeofday(&t, NULL);
+  return t.tv_sec * 1000000ULL + t.tv_usec;
+}
+
+// Time fn(context), which processes `items` items, and print the time per item.
+static void microbench(const char* name, void (*fn)(void* context),
+                       void* context, unsigned items) {
+  unsigned long long best = -1;
+  for (int i = 0; i < microbench_runs; i++) {
+    const unsigned long long start = microbench_now();
+    fn(context);
+    const unsigned long long time = microbench_now() - start;
+    if (time < best) best = time;
+  }
+  // Hundredths of a nanosecond per item.
+  const unsigned scaled = (int)(best * 100000.0 / items);
+  printf("%s: %u.%s%u ns/item\n", name, scaled / 100,
+         scaled % 100 < 10 ? "0" : "", scaled % 100);
+}
@@ -0,0 +1,87 @@
+// Compare read_int, one number at a time, against the bulk SWAR parser in
+// read_int_list on a newline-separated list of random numbers.
+
+#include "microbench/microbench.h"
+#include "util/arena.h"
+#include "util/die.h"
+#include "util/read_int.h"
+#include "util/read_int_list.h"
+
+enum { num_values = 1 << 20 };
+
+struct list {
+  const char* begin;
+  const char* end;
+  unsigned* values;
+  int count;
+};
+
+static void run_read_int(void* context) {
+  struct list* list = context;
+  const char* i = list->begin;
+  int n = 0;
+  while (i != list->end) {
+    i = read_int(i, &list->values[n++]);
+    if (*i != '\n') die("bad");
+    i++;
+  }
+  list->count = n;
+}
+
+static void run_read_int_list(void* context) {
+  struct list* list = context;
+  const char* const i = read_int_list(list->begin, list->end, '\n',
+                                      list->values, num_values, &list->count);
+  if (i != list->end) die("bad");
+}
+
+// Fill a list with newline-separated random numbers, each of which is below
+// 10^max_digits, and record their values in `expected`.
+static void generate(struct list* list, int max_digits, unsigned* expected) {
+  // Leave room for read_int_list to read past the end of the text.
+  char* const text = ARENA_RESERVE(char, 11 * num_values + 8);
+  char* o = text;
+  unsigned seed = max_digits;
+  for (int i = 0; i < num_values; i++) {
+    seed = seed * 1103515245 + 12345;
+    // Use the high bits, since the low bits of the generator are weak.
+    const unsigned x = seed >> 8;
+    const unsigned value = max_digits < 10 ? x % read_int_powers[max_digits]
+                                           : x << (seed >> 27);
+    expected[i] = value;
+    char digits[10];
+    int n = 0;
+    unsigned v = value;
+    do {
+      digits[n++] = '0' + v % 10;
+      v /= 10;
+    } while (v);
+    while (n) *o++ = digits[--n];
+    *o++ = '\n';
+  }
+  list->begin = text;
+  list->end = o;
+}
+
+static void check(struct list* list, const unsigned* expected) {
+  run_read_int_list(list);
+  if (list->count != num_values) die("count");
+  for (int i = 0; i < num_values; i++) {
+    if (list->values[i] != expected[i]) die("mismatch");
+  }
+}
+
+int main() {
+  unsigned* const expected = ARENA_RESERVE(unsigned, num_values);
+  struct list list = {.values = ARENA_RESERVE(unsigned, num_values)};
+  // Numbers of up to 4 digits, which is typical of the puzzle inputs.
+  generate(&list, 4, expected);
+  check(&list, expected);
+  microbench("read_int (short)", run_read_int, &list, num_values);
+  microbench("read_int_list (short)", run_read_int_list, &list, num_values);
+  // Numbers with up to 10 digits.
+  generate(&list, 10, expected);
+  check(&list, expected);
+  microbench("read_int (long)", run_read_int, &list, num_values);
+  microbench("read_int_list (long)", run_read_int_list, &list, num_values);
+}
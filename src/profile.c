@@ -0,0 +1,67 @@
+// Profile runtime for the instrumented stage of `make fast`. The usual runtime
+// in libgcov writes .gcda files through libc when the process exits, which we
+// don't have. Instead, the solvers are built with -fprofile-info-section, which
+// leaves a pointer to each translation unit's counters in the gcov_info
+// section, and exit() calls write_profile to serialize them to file descriptor
+// 3 using the one libc-free entry point in libgcov. src/train.sh collects and
+// merges the results.
+
+#include "util/syscall.h"
+
+enum { profile_fd = 3 };
+
+struct gcov_info;
+
+void __gcov_info_to_gcda(const struct gcov_info* info,
+                         void (*filename_fn)(const char* name, void* arg),
+                         void (*dump_fn)(const void* data, unsigned size,
+                                         void* arg),
+                         void* (*allocate_fn)(unsigned size, void* arg),
+                         void* arg);
+
+// Provided by the linker for sections whose names are C identifiers.
+extern const struct gcov_info* const __start_gcov_info[];
+extern const struct gcov_info* const __stop_gcov_info[];
+
+// libgcov refers to these libc functions.
+
+void abort(void) {
+  syscall1(SYS_exit_group, 134);
+  __builtin_unreachable();
+}
+
+void* mmap(void* address, unsigned long length, int protection, int flags,
+           int fd, long offset) {
+  return (void*)syscall6(SYS_mmap, (long)address, length, protection, flags,
+                         fd, offset);
+}
+
+// The counters are merged offline by gcov-tool rather than at exit, so the
+// merge function referenced by each gcov_info is never called.
+void __gcov_merge_add(void) {
+  abort();
+}
+
+static void profile_filename(const char* name, void* arg) {
+  (void)name;
+  (void)arg;
+}
+
+static void profile_dump(const void* data, unsigned size, void* arg) {
+  (void)arg;
+  syscall3(SYS_write, profile_fd, (long)data, size);
+}
+
+static void* profile_allocate(unsigned size, void* arg) {
+  (void)arg;
+  enum { prot_read_write = 3, map_private_anonymous = 0x22 };
+  return mmap(0, size, prot_read_write, map_private_anonymous, -1, 0);
+}
+
+void write_profile(void) {
+  for (const struct gcov_info* const* info = __start_gcov_info;
+       info != __stop_gcov_info; info++) {
+    __gcov_info_to_gcda(*info, profile_filename, profile_dump,
+                        profile_allocate, 0);
+  }
+}
@@ -1,5 +1,17 @@
 #!/bin/bash
 
-find bin/opt -type f -executable -printf '%f %5s\n' | sort
-find bin/opt -type f -executable -printf '%s\n' |
+# Usage: src/size.sh [flavor], where the flavor is opt (the default) or opt64.
+flavor="${1:-opt}"
+
+# Solvers which use the work-stealing scheduler in util/parallel.h carry its
+# code, so they are marked to keep that cost visible.
+find "bin/${flavor}" -type f -executable -name 'day*' -printf '%f %5s\n' | sort |
+while read -r name size; do
+  if grep -q 'util/parallel.h' "src/${name}.c" 2>/dev/null; then
+    printf '%s %5s parallel\n' "${name}" "${size}"
+  else
+    printf '%s %5s\n' "${name}" "${size}"
+  fi
+done
+find "bin/${flavor}" -type f -executable -name 'day*' -printf '%s\n' |
 awk '{count += $1} END {print "total " count}'
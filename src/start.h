@@ -10,49 +10,127 @@
 #define STDERR_FILENO 2u
 #define NULL ((void*)0)
 
-typedef unsigned int size_t;
-typedef int ssize_t;
+typedef __SIZE_TYPE__ size_t;
+typedef __PTRDIFF_TYPE__ ssize_t;
 #define bool _Bool
 #define true ((_Bool)1)
 #define false ((_Bool)0)
 
-// System calls. We will only use three: read, write, and exit.
+// System calls. The core set is read, write, and exit. Headers under util/
+// provide wrappers for any others that a solver needs.
+#include "util/syscall.h"
 
 __attribute__((access (write_only, 2)))
 static ssize_t read(unsigned int fd, void* buffer, size_t size) {
-  ssize_t result;
-  asm volatile("int $0x80"
-               : "=a"(result)
-               : "a"(3), "b"(fd), "c"(buffer), "d"(size)
-               : "memory");
-  return result;
+  return syscall3(SYS_read, fd, (long)buffer, size);
 }
 
 __attribute__((access (read_only, 2)))
 static ssize_t write(unsigned int fd, const void* buffer, size_t size) {
-  ssize_t result;
-  asm volatile("int $0x80"
-               : "=a"(result)
-               : "a"(4), "b"(fd), "c"(buffer), "d"(size)
-               : "memory");
-  return result;
+  return syscall3(SYS_write, fd, (long)buffer, size);
 }
 
+// Defined by util/output.h if the solver buffers its output.
+__attribute__((weak)) void flush_output(void);
+#if defined(PERF_COUNTERS) && !defined(TRACE)
+// Performance counters are reported for each phase traced by util/trace.h.
+#define TRACE
+#endif
+#ifdef TRACE
+// Defined by util/trace.h.
+__attribute__((weak)) void write_trace(void);
+#endif
+#ifdef PROFILE_GUIDED
+// Defined by src/profile.c in the instrumented stage of a profile-guided build.
+// Both stages must have the same control flow, so the reference is weak.
+__attribute__((weak)) void write_profile(void);
+#endif
+#ifdef BATCH
+// Defined by util/batch.h.
+static void batch_exit(int code);
+#endif
+#ifdef ANSWER_CACHE
+#ifdef BATCH
+#error "ANSWER_CACHE and BATCH can't be combined"
+#endif
+// Defined by util/answer_cache.h.
+static void answer_cache_exit(int code);
+#endif
+
+// Exit the process. This uses exit_group rather than exit so that it also
+// terminates any threads started by util/thread.h.
 static __attribute__((noreturn)) void exit(int code) {
-  asm volatile("int $0x80" : : "a"(1), "b"(code));
+  if (flush_output) flush_output();
+#ifdef TRACE
+  if (write_trace) write_trace();
+#endif
+#ifdef PROFILE_GUIDED
+  if (write_profile) write_profile();
+#endif
+#ifdef BATCH
+  batch_exit(code);
+#endif
+#ifdef ANSWER_CACHE
+  answer_cache_exit(code);
+#endif
+  syscall1(SYS_exit_group, code);
+  __builtin_unreachable();
 }
 
-// Entry point. We will invoke main from _start.
+// Entry point. Solvers may define main with no parameters, or as
+// main(int argc, char** argv) to take arguments.
 
 static int main();
 
-__attribute__((force_align_arg_pointer))
-__attribute__((noreturn)) void _start() {
-  // Upon ELF entry, the top of the stack is argc, argv[0], argv[1], etc.
-  // However, we can't easily access that from here since the compiler may
-  // or may not insert function prelude that adjusts the stack pointer.
-  exit(main());
+#ifdef BATCH
+#include "util/batch.h"
+#endif
+#ifdef ANSWER_CACHE
+#include "util/answer_cache.h"
+#endif
+
+#ifdef MULTICALL
+// In the multi-call binary (see src/aoc.c), each solver is entered through a
+// function named by MULTICALL rather than through _start.
+__attribute__((noreturn)) void MULTICALL(int argc, char** argv) {
+  exit(main(argc, argv));
+}
+#else
+// Upon ELF entry, the top of the stack is argc, argv[0], argv[1], etc. A C
+// function can't find that reliably because of the compiler's prologue, so
+// _start passes the initial stack pointer on to start_main, realigning the
+// stack for the call as the ABI requires.
+#ifdef __x86_64__
+__asm__(
+    ".text\n"
+    ".globl _start\n"
+    "_start:\n"
+    "  mov %rsp, %rdi\n"
+    "  and $-16, %rsp\n"
+    "  call start_main\n");
+#define START_MAIN_ABI
+#else
+__asm__(
+    ".text\n"
+    ".globl _start\n"
+    "_start:\n"
+    "  mov %esp, %eax\n"
+    "  and $-16, %esp\n"
+    "  call start_main\n");
+#define START_MAIN_ABI __attribute__((regparm(1)))
+#endif
+
+__attribute__((noreturn, used)) START_MAIN_ABI void start_main(long* stack) {
+#ifdef BATCH
+  batch_start(stack);
+#else
+#ifdef ANSWER_CACHE
+  answer_cache_start(stack);
+#endif
+  exit(main((int)stack[0], (char**)(stack + 1)));
+#endif
 }
+#endif
 
 // The compiler can automatically generate calls to these functions, so we must
 // unconditionally include definitions for them.
@@ -0,0 +1,28 @@
+#!/bin/bash
+
+# Usage: src/train.sh <profile> <instrumented solver> <inputs...>
+#
+# Runs an instrumented solver (see src/profile.c) on each input and merges the
+# resulting profiles into a single .gcda file for the -fprofile-use stage.
+
+set -e
+
+profile="${1?}"
+solver="${2?}"
+shift 2
+
+name="$(basename "${profile}")"
+work="$(mktemp -d)"
+trap 'rm -rf "${work}"' EXIT
+mkdir "${work}/total" "${work}/run"
+
+for input in "$@"; do
+  "${solver}" <"${input}" >/dev/null 3>"${work}/run/${name}"
+  if [[ -f "${work}/total/${name}" ]]; then
+    gcov-tool merge -o "${work}/total" "${work}/total" "${work}/run"
+  else
+    cp "${work}/run/${name}" "${work}/total/${name}"
+  fi
+done
+
+cp "${work}/total/${name}" "${profile}"
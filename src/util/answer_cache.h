@@ -0,0 +1,172 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// A persistent cache of answers, enabled with -DANSWER_CACHE. Before main runs,
+// the whole of stdin is hashed, and the cache file is searched for an entry
+// with the same key. On a hit, the cached output is written and the solver
+// doesn't run at all. On a miss, the solver runs with its output captured, and
+// if it exits successfully the output is appended to the cache file.
+//
+// The key combines a hash of the input with a hash of the solver itself: its
+// loaded code and initialized data, and its arguments. Rebuilding a solver, or
+// running it with different arguments, therefore never reuses stale answers.
+//
+// The cache file is named by the ANSWER_CACHE environment variable, and is
+// .answer_cache in the current directory by default. It is a sequence of
+// entries, each a header followed by the output, and is searched linearly, so
+// it is meant to stay small. Deleting it is always safe. Any failure to use the
+// cache is ignored, and the solver simply runs as normal.
+
+#include "elf.h"
+#include "files.h"
+#include "fstat.h"
+#include "map_input.h"
+#include "mmap.h"
+#include "strlen.h"
+#include "xxhash.h"
+
+// The layout is the same on i386 and x86_64.
+struct answer_cache_entry {
+  unsigned solver[2];
+  unsigned input[2];
+  unsigned length;
+};
+
+static struct {
+  const char* path;
+  struct answer_cache_entry key;
+  // The original stdout, while the solver's output is being captured.
+  int output;
+  bool capturing;
+} answer_cache;
+
+static void answer_cache_set_key(unsigned key[2], unsigned long long hash) {
+  key[0] = hash;
+  key[1] = hash >> 32;
+}
+
+// Write the cached output for the key, if there is one, and return whether it
+// was found.
+static bool answer_cache_lookup(void) {
+  const int fd = open(answer_cache.path, O_RDONLY, 0);
+  if (fd < 0) return false;
+  struct stat info;
+  bool found = false;
+  if (fstat(fd, &info) == 0 && info.st_size > 0) {
+    const char* const file =
+        mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (!map_failed(file)) {
+      const char* i = file;
+      const char* const end = file + info.st_size;
+      const struct answer_cache_entry* const key = &answer_cache.key;
+      while (!found && (size_t)(end - i) >= sizeof(*key)) {
+        struct answer_cache_entry entry;
+        __builtin_memcpy(&entry, i, sizeof(entry));
+        i += sizeof(entry);
+        if (entry.length > (size_t)(end - i)) break;
+        if (entry.solver[0] == key->solver[0] &&
+            entry.solver[1] == key->solver[1] &&
+            entry.input[0] == key->input[0] &&
+            entry.input[1] == key->input[1]) {
+          write_all(STDOUT_FILENO, i, entry.length);
+          found = true;
+        }
+        i += entry.length;
+      }
+      munmap((void*)file, info.st_size);
+    }
+  }
+  close(fd);
+  return found;
+}
+
+// Called by _start with the initial stack pointer, before main. This only
+// returns if the solver needs to run.
+static void answer_cache_start(long* stack) {
+  answer_cache.path = ".answer_cache";
+  static const char name[] = "ANSWER_CACHE=";
+  for (char** env = initial_environment(stack); *env; env++) {
+    int n = 0;
+    while (n < (int)sizeof(name) - 1 && (*env)[n] == name[n]) n++;
+    if (n == sizeof(name) - 1) answer_cache.path = *env + n;
+  }
+
+  // Nothing has run yet, so the loaded image is exactly what was built.
+  unsigned long long solver = 0;
+  int num_headers;
+  const struct program_header* const headers =
+      program_headers(stack, &num_headers);
+  for (int i = 0; i < num_headers; i++) {
+    if (headers[i].type != PT_LOAD) continue;
+    solver = xxh64((const void*)headers[i].address, headers[i].file_size,
+                   solver);
+  }
+  char** const argv = (char**)(stack + 1);
+  for (int i = 1; i < stack[0]; i++) {
+    // Include the terminator, so that the boundaries between arguments count.
+    solver = xxh64(argv[i], strlen(argv[i]) + 1, solver);
+  }
+  answer_cache_set_key(answer_cache.key.solver, solver);
+
+  int length;
+  const char* const input = map_input(&length);
+  answer_cache_set_key(answer_cache.key.input, xxh64(input, length, 0));
+  if (answer_cache_lookup()) {
+    syscall1(SYS_exit_group, 0);
+    __builtin_unreachable();
+  }
+
+  // The solver reads stdin from the start. If it was a pipe, it has been
+  // drained, so the input is handed over in a memory file instead.
+  if (lseek(STDIN_FILENO, 0, SEEK_SET) < 0) {
+    const int in = memfd_create("input");
+    if (in < 0) return;
+    write_all(in, input, length);
+    lseek(in, 0, SEEK_SET);
+    dup2(in, STDIN_FILENO);
+    close(in);
+  }
+  const int out = memfd_create("output");
+  if (out < 0) return;
+  answer_cache.output = dup(STDOUT_FILENO);
+  if (answer_cache.output < 0) {
+    close(out);
+    return;
+  }
+  dup2(out, STDOUT_FILENO);
+  close(out);
+  answer_cache.capturing = true;
+}
+
+// Called by exit() once the output has been flushed. Writes the captured
+// output to the real stdout and, if the solver succeeded, to the cache.
+static void answer_cache_exit(int code) {
+  if (!answer_cache.capturing) return;
+  answer_cache.capturing = false;
+  const long length = lseek(STDOUT_FILENO, 0, SEEK_CUR);
+  if (length < 0) die("lseek");
+  struct answer_cache_entry* const entry =
+      mmap(NULL, sizeof(*entry) + length, PROT_READ | PROT_WRITE,
+           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (map_failed(entry)) die("mmap");
+  *entry = answer_cache.key;
+  entry->length = length;
+  char* const output = (char*)(entry + 1);
+  lseek(STDOUT_FILENO, 0, SEEK_SET);
+  for (long i = 0; i < length;) {
+    const ssize_t len = read(STDOUT_FILENO, output + i, length - i);
+    if (len <= 0) die("read");
+    i += len;
+  }
+  // sendfile can't be used here, as it rejects a stdout opened for appending.
+  write_all(answer_cache.output, output, length);
+  if (code != 0) return;
+  // The entry is appended with a single write, so that solvers running at the
+  // same time don't interleave their entries.
+  const int fd = open(answer_cache.path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (fd < 0) return;
+  write(fd, entry, sizeof(*entry) + length);
+  close(fd);
+}
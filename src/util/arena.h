@@ -0,0 +1,80 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// A bump allocator for tables whose size depends on the input. The arena lives
+// at the end of the heap, and the program break is moved forward in large steps
+// as it fills up. The kernel only backs pages once they are touched, so
+// reserving a generous bound derived from the input size is cheap.
+//
+// Allocations are never freed individually. Instead, arena_mark records the
+// current position and arena_reset later rolls back to it, releasing everything
+// that was allocated in between. Like .bss, all allocations are zeroed.
+
+#include "brk.h"
+#include "die.h"
+#include "memset.h"
+
+enum { arena_step = 1 << 20 };
+
+static struct {
+  char* top;    // The next free byte.
+  char* dirty;  // Memory below this may have been used since it was mapped.
+  char* limit;  // The current program break.
+} arena;
+
+static void arena_init(void) {
+  if (arena.limit) return;
+  arena.limit = brk(NULL);
+  arena.top = arena.dirty = arena.limit;
+}
+
+// Allocate `size` zeroed bytes aligned to `align`, which is a power of two.
+static void* arena_alloc(size_t size, size_t align) {
+  arena_init();
+  char* const result = (char*)(((size_t)arena.top + align - 1) & -align);
+  // With a large alignment, the result may even be beyond the current break.
+  if (result > arena.limit || size > (size_t)(arena.limit - result)) {
+    if (size > 0x7FFFFFFF) die("too big");
+    const size_t needed = result + size - arena.limit;
+    char* const limit = arena.limit + ((needed + arena_step - 1) & -arena_step);
+    if (brk(limit) != limit) die("brk");
+    arena.limit = limit;
+  }
+  arena.top = result + size;
+  // Memory which has never been handed out is still zero from the kernel.
+  if (result < arena.dirty) {
+    const size_t used = arena.dirty - result;
+    memset(result, 0, size < used ? size : used);
+  }
+  if (arena.top > arena.dirty) arena.dirty = arena.top;
+  return result;
+}
+
+static void* arena_alloc_array(size_t size, size_t align, size_t count) {
+  if (count && size > 0x7FFFFFFF / count) die("too big");
+  return arena_alloc(size * count, align);
+}
+
+// Allocate an array of `count` objects of the given type. Reserving zero
+// objects is allowed: it returns a suitably aligned pointer to the top of the
+// arena, which can then be grown one element at a time with ARENA_PUSH.
+#define ARENA_RESERVE(type, count) \
+  ((type*)arena_alloc_array(sizeof(type), _Alignof(type), (count)))
+
+// Allocate a single object of the given type. Consecutive pushes of one type
+// with no other allocations in between are contiguous, so they extend an array
+// started with ARENA_RESERVE.
+#define ARENA_PUSH(type) ((type*)arena_alloc(sizeof(type), _Alignof(type)))
+
+// Returns the current position of the arena, for use with arena_reset.
+static char* arena_mark(void) {
+  arena_init();
+  return arena.top;
+}
+
+// Release every allocation made since the corresponding call to arena_mark.
+static void arena_reset(char* mark) {
+  arena.top = mark;
+}
@@ -0,0 +1,236 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// Batch mode (-DBATCH) runs a solver on many inputs in one process. Each record
+// on stdin is a line holding the length of an input in bytes, followed by the
+// input itself. The solver runs once per record, with that input as its stdin.
+// The output of each run is written to stdout as a line holding its exit status
+// and length, followed by the output itself.
+//
+// Solvers need no changes to support this. Before each record, every writable
+// segment of the program is put back as it was at startup: the initialized part
+// is copied from a snapshot, and the rest (.bss) is zeroed. The program break is
+// moved back too, so the arena starts afresh, and the mapping that map_input
+// made of the last record's input is unmapped. The records are read from stdin
+// one at a time, so memory use doesn't grow with the length of the batch.
+
+#include "brk.h"
+#include "die.h"
+#include "elf.h"
+#include "files.h"
+#include "format_int.h"
+#include "map_input.h"
+#include "memcpy.h"
+#include "memset.h"
+#include "mmap.h"
+
+enum { max_segments = 4, max_mappings = 4, batch_buffer_size = 65536 };
+
+struct segment {
+  char* address;
+  size_t file_size, memory_size;
+  char* snapshot;
+};
+
+struct mapping {
+  void* address;
+  size_t size;
+};
+
+struct batch {
+  // The original stdin, from which the records are read.
+  int input;
+  // The part of the buffer which has been read but not yet used is [next, end).
+  const char* next;
+  const char* end;
+  int argc;
+  char** argv;
+  // The stack pointer at the start of each record.
+  char* stack;
+  // The initial program break.
+  void* heap;
+  // The original stdout.
+  int output;
+  bool running;
+  // The exit statuses of every record, ORed together.
+  int status;
+  int num_segments;
+  struct segment segments[max_segments];
+  // The inputs mapped by the current record.
+  int num_mappings;
+  struct mapping mappings[max_mappings];
+  char buffer[batch_buffer_size];
+};
+
+// The state lives in a separate mapping so that it survives the reset between
+// records. This pointer doesn't, so it is saved and restored around it.
+static struct batch* batch;
+
+static void batch_input_mapped(void* address, size_t size) {
+  struct batch* const b = batch;
+  if (b->num_mappings == max_mappings) die("too many mappings");
+  b->mappings[b->num_mappings].address = address;
+  b->mappings[b->num_mappings].size = size;
+  b->num_mappings++;
+}
+
+static void batch_reset(void) {
+  struct batch* const b = batch;
+  for (int i = 0; i < b->num_mappings; i++) {
+    munmap(b->mappings[i].address, b->mappings[i].size);
+  }
+  b->num_mappings = 0;
+  for (int i = 0; i < b->num_segments; i++) {
+    const struct segment* const s = &b->segments[i];
+    memcpy(s->address, s->snapshot, s->file_size);
+    // The page holding the end of the initialized data is mapped from the file,
+    // so the rest of it is zeroed by hand. The pages after it are anonymous, and
+    // discarding them makes the kernel supply zero pages on the next access.
+    char* const zero = s->address + s->file_size;
+    char* const end = s->address + s->memory_size;
+    char* const page = (char*)round_to_pages((size_t)zero);
+    memset(zero, 0, (page < end ? page : end) - zero);
+    if (page < end) madvise(page, end - page, MADV_DONTNEED);
+  }
+  batch = b;
+  brk(b->heap);
+}
+
+static __attribute__((noreturn)) void batch_next(void);
+
+// Abandon the current stack and run the next record.
+static __attribute__((noreturn)) void batch_switch(void) {
+#ifdef __x86_64__
+  asm volatile("mov %0, %%rsp\n"
+               "call %P1\n"
+               :
+               : "r"(batch->stack), "i"(batch_next));
+#else
+  asm volatile("mov %0, %%esp\n"
+               "call %P1\n"
+               :
+               : "r"(batch->stack), "i"(batch_next));
+#endif
+  __builtin_unreachable();
+}
+
+// Read more of the batch into the buffer, once all of it has been used. Returns
+// false at the end of the batch.
+static bool batch_fill(struct batch* b) {
+  const int len = read(b->input, b->buffer, batch_buffer_size);
+  if (len < 0) die("read");
+  b->next = b->buffer;
+  b->end = b->buffer + len;
+  return len > 0;
+}
+
+static __attribute__((noreturn)) void batch_next(void) {
+  struct batch* const b = batch;
+  // This header is included in every solver, so it uses no parsing helpers
+  // which might clash with the solver's own.
+  size_t length = 0;
+  int digits = 0;
+  while (true) {
+    if (b->next == b->end && !batch_fill(b)) {
+      if (digits) die("bad record");
+      syscall1(SYS_exit_group, b->status);
+      __builtin_unreachable();
+    }
+    const char c = *b->next++;
+    if (c == '\n') break;
+    if (c < '0' || '9' < c || ++digits > 18) die("bad record");
+    length = 10 * length + (c - '0');
+  }
+  if (!digits) die("bad record");
+  batch_reset();
+  const int in = memfd_create("input");
+  if (in < 0) die("memfd_create");
+  // Copy the input from the buffer, refilling it as it runs out.
+  while (length) {
+    if (b->next == b->end && !batch_fill(b)) die("bad record");
+    const size_t available = b->end - b->next;
+    const size_t n = available < length ? available : length;
+    write_all(in, b->next, n);
+    b->next += n;
+    length -= n;
+  }
+  lseek(in, 0, SEEK_SET);
+  dup2(in, STDIN_FILENO);
+  close(in);
+  const int out = memfd_create("output");
+  if (out < 0) die("memfd_create");
+  dup2(out, STDOUT_FILENO);
+  close(out);
+  b->running = true;
+  exit(main(b->argc, b->argv));
+}
+
+// Called by exit(). If a record is running, this writes out its result and
+// moves on to the next record. Otherwise, it returns and the process exits.
+static void batch_exit(int code) {
+  struct batch* const b = batch;
+  if (b == NULL || !b->running) return;
+  b->running = false;
+  b->status |= code;
+  const long length = lseek(STDOUT_FILENO, 0, SEEK_CUR);
+  char header[24];
+  char* const end = header + sizeof(header);
+  end[-1] = '\n';
+  char* start = format_digits(end - 1, length);
+  *--start = ' ';
+  start = format_digits(start, code & 0xFF);
+  write_all(b->output, start, end - start);
+  long offset = 0;
+  while (offset < length) {
+    if (sendfile(b->output, STDOUT_FILENO, &offset, length - offset) <= 0) {
+      die("sendfile");
+    }
+  }
+  batch_switch();
+}
+
+// Called by _start with the initial stack pointer, in place of main.
+static __attribute__((noreturn)) void batch_start(long* stack) {
+  int num_headers;
+  const struct program_header* const headers =
+      program_headers(stack, &num_headers);
+  size_t snapshot_size = 0;
+  for (int i = 0; i < num_headers; i++) {
+    const struct program_header* const h = &headers[i];
+    if (h->type == PT_LOAD && (h->flags & PF_W)) snapshot_size += h->file_size;
+  }
+  struct batch* const b =
+      mmap(NULL, sizeof(struct batch) + snapshot_size, PROT_READ | PROT_WRITE,
+           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (map_failed(b)) die("mmap");
+  char* snapshot = (char*)(b + 1);
+  for (int i = 0; i < num_headers; i++) {
+    const struct program_header* const h = &headers[i];
+    if (h->type != PT_LOAD || !(h->flags & PF_W)) continue;
+    if (b->num_segments == max_segments) die("too many segments");
+    struct segment* const s = &b->segments[b->num_segments++];
+    s->address = (char*)h->address;
+    s->file_size = h->file_size;
+    s->memory_size = h->memory_size;
+    s->snapshot = snapshot;
+    snapshot += h->file_size;
+  }
+  b->input = dup(STDIN_FILENO);
+  if (b->input < 0) die("dup");
+  b->argc = stack[0];
+  b->argv = (char**)(stack + 1);
+  // Records run on the stack below argc.
+  b->stack = (char*)((long)stack & -16);
+  b->heap = brk(NULL);
+  b->output = dup(STDOUT_FILENO);
+  if (b->output < 0) die("dup");
+  batch = b;
+  // Nothing has changed the solver's state yet, so this is its initial state.
+  for (int i = 0; i < b->num_segments; i++) {
+    const struct segment* const s = &b->segments[i];
+    memcpy(s->snapshot, s->address, s->file_size);
+  }
+  batch_switch();
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// Complement probes against a packed bitset: given a sorted list of values, find
+// the first j for which remaining - values[j] is in the set. bits[x >> 5] holds
+// bit x & 31 for each x in the set. The first call checks the CPU once and
+// points bitset_probe at the AVX2 kernel, which tests eight values at a time by
+// gathering their bitset words with one instruction, or at the scalar loop.
+
+#include "cpuid.h"
+
+typedef int bitset_v8si __attribute__((vector_size(32)));
+typedef unsigned bitset_v8su __attribute__((vector_size(32)));
+// An unaligned vector of values, which may alias anything.
+typedef unsigned bitset_v8su_unaligned
+    __attribute__((vector_size(32), aligned(4), may_alias));
+typedef float bitset_v8sf __attribute__((vector_size(32)));
+
+// Returns the first j in [begin, end) for which remaining - values[j] is in the
+// set, or end if there is none. Each complement must be within the bitset.
+static int bitset_probe_scalar(const unsigned* bits, const unsigned* values,
+                               int begin, int end, unsigned remaining) {
+  for (int j = begin; j < end; j++) {
+    const unsigned x = remaining - values[j];
+    if (bits[x >> 5] >> (x & 31) & 1) return j;
+  }
+  return end;
+}
+
+__attribute__((target("avx2")))
+static int bitset_probe_avx2(const unsigned* bits, const unsigned* values,
+                             int begin, int end, unsigned remaining) {
+  bitset_v8su r = {0};
+  r += remaining;
+  const bitset_v8si zero = {0};
+  const bitset_v8si all = zero - 1;
+  int j = begin;
+  for (; end - j >= 8; j += 8) {
+    const bitset_v8su x = r - *(const bitset_v8su_unaligned*)(values + j);
+    const bitset_v8si words = __builtin_ia32_gathersiv8si(
+        zero, (const int*)bits, (bitset_v8si)(x >> 5), all, 4);
+    // Move each lane's bit up to its sign, which movmskps collects.
+    const bitset_v8su found = (bitset_v8su)words << (31 - (x & 31));
+    const int mask = __builtin_ia32_movmskps256((bitset_v8sf)found);
+    if (mask) return j + __builtin_ctz(mask);
+  }
+  return bitset_probe_scalar(bits, values, j, end, remaining);
+}
+
+static int bitset_probe_resolve(const unsigned* bits, const unsigned* values,
+                                int begin, int end, unsigned remaining);
+
+static int (*bitset_probe)(const unsigned* bits, const unsigned* values,
+                           int begin, int end, unsigned remaining) =
+    bitset_probe_resolve;
+
+static int bitset_probe_resolve(const unsigned* bits, const unsigned* values,
+                                int begin, int end, unsigned remaining) {
+  bitset_probe = cpu_features() & cpu_avx2 ? bitset_probe_avx2
+                                           : bitset_probe_scalar;
+  return bitset_probe(bits, values, begin, end, remaining);
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// Move the program break (the end of the heap) to the given address. Returns
+// the new break, which is unchanged from the old one on failure. Passing NULL
+// queries the current break.
+static void* brk(void* address) {
+  return (void*)syscall1(SYS_brk, (long)address);
+}
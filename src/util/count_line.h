@@ -0,0 +1,127 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// Scanning to the end of a line while counting one byte value along the way.
+// The vector kernels compare a whole block with both the byte and the newline,
+// collect the results as bit masks with pmovmskb, and count the matches before
+// the first newline with popcnt. Whatever is left when less than a block
+// remains is handled by the scalar loop. The AVX2 kernel starts with 16-byte
+// blocks, so that short lines never pay for the wider vectors. The first call
+// checks the CPU once and points count_line at the widest kernel that it
+// supports.
+
+#include "cpuid.h"
+#include "popcount.h"
+
+// Unaligned vectors which may alias anything.
+typedef char count_line_v16
+    __attribute__((vector_size(16), aligned(1), may_alias));
+typedef char count_line_v32
+    __attribute__((vector_size(32), aligned(1), may_alias));
+
+// Returns the address of the first newline in [i, end), or end if there is
+// none, and sets *count to the number of bytes equal to c before it.
+static const char* count_line_scalar(const char* i, const char* end, char c,
+                                     int* count) {
+  int n = 0;
+  while (i != end && *i != '\n') n += *i++ == c;
+  *count = n;
+  return i;
+}
+
+// Count the bytes equal to c in the 16 bytes at i, adding them to *n. Returns
+// the address of the first newline among them, counting only the bytes before
+// it, or NULL if there is none.
+__attribute__((target("sse2"), always_inline))
+static inline const char* count_line_block16(const char* i, char c, int* n) {
+  count_line_v16 needle = {0}, newline = {0};
+  needle += c;
+  newline += '\n';
+  const count_line_v16 v = *(const count_line_v16*)i;
+  const unsigned newlines =
+      __builtin_ia32_pmovmskb128((count_line_v16)(v == newline));
+  const unsigned matches =
+      __builtin_ia32_pmovmskb128((count_line_v16)(v == needle));
+  if (newlines) {
+    // Only the matches below the first newline count.
+    *n += popcount(matches & ((newlines & -newlines) - 1));
+    return i + __builtin_ctz(newlines);
+  }
+  *n += popcount(matches);
+  return NULL;
+}
+
+__attribute__((target("sse2")))
+static const char* count_line_sse2(const char* i, const char* end, char c,
+                                   int* count) {
+  int n = 0;
+  for (; end - i >= 16; i += 16) {
+    const char* const line_end = count_line_block16(i, c, &n);
+    if (line_end) {
+      *count = n;
+      return line_end;
+    }
+  }
+  int tail;
+  i = count_line_scalar(i, end, c, &tail);
+  *count = n + tail;
+  return i;
+}
+
+__attribute__((target("avx2")))
+static const char* count_line_avx2(const char* i, const char* end, char c,
+                                   int* count) {
+  count_line_v32 needle = {0}, newline = {0};
+  needle += c;
+  newline += '\n';
+  int n = 0;
+  // Most lines in the puzzle are shorter than a 32-byte vector, and for those
+  // 16-byte vectors are quicker. The first 32 bytes are therefore checked with
+  // SSE2, and the AVX2 loop only runs on lines which are longer than that.
+  for (int j = 0; j < 2 && end - i >= 16; j++, i += 16) {
+    const char* const line_end = count_line_block16(i, c, &n);
+    if (line_end) {
+      *count = n;
+      return line_end;
+    }
+  }
+  for (; end - i >= 32; i += 32) {
+    const count_line_v32 v = *(const count_line_v32*)i;
+    const unsigned newlines =
+        __builtin_ia32_pmovmskb256((count_line_v32)(v == newline));
+    const unsigned matches =
+        __builtin_ia32_pmovmskb256((count_line_v32)(v == needle));
+    if (newlines) {
+      *count = n + popcount(matches & ((newlines & -newlines) - 1));
+      return i + __builtin_ctz(newlines);
+    }
+    n += popcount(matches);
+  }
+  int tail;
+  i = count_line_sse2(i, end, c, &tail);
+  *count = n + tail;
+  return i;
+}
+
+static const char* count_line_resolve(const char* i, const char* end, char c,
+                                      int* count);
+
+static const char* (*count_line)(const char* i, const char* end, char c,
+                                 int* count) = count_line_resolve;
+
+static const char* count_line_resolve(const char* i, const char* end, char c,
+                                      int* count) {
+  const unsigned features = cpu_features();
+  if (!(features & cpu_popcnt)) {
+    count_line = count_line_scalar;
+  } else if (features & cpu_avx2) {
+    count_line = count_line_avx2;
+  } else if (features & cpu_sse2) {
+    count_line = count_line_sse2;
+  } else {
+    count_line = count_line_scalar;
+  }
+  return count_line(i, end, c, count);
+}
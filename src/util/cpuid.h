@@ -0,0 +1,59 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// Runtime detection of optional instruction set extensions, for solvers which
+// select an implementation based on the CPU that they are running on.
+
+struct cpuid {
+  unsigned eax, ebx, ecx, edx;
+};
+
+static struct cpuid cpuid(unsigned leaf, unsigned subleaf) {
+  struct cpuid result;
+  asm("cpuid"
+      : "=a"(result.eax), "=b"(result.ebx), "=c"(result.ecx), "=d"(result.edx)
+      : "a"(leaf), "c"(subleaf));
+  return result;
+}
+
+// Read an extended control register. Only valid if the OS has set OSXSAVE.
+static unsigned long long xgetbv(unsigned index) {
+  unsigned low, high;
+  asm("xgetbv" : "=a"(low), "=d"(high) : "c"(index));
+  return (unsigned long long)high << 32 | low;
+}
+
+enum cpu_feature {
+  cpu_sse2 = 1 << 0,
+  cpu_popcnt = 1 << 1,
+  cpu_avx2 = 1 << 2,
+  // Enhanced rep movsb/stosb: the string instructions are fast for large
+  // blocks.
+  cpu_erms = 1 << 3,
+};
+
+static int cpu_feature_cache = -1;
+
+// Returns the set of supported features as a mask of cpu_feature values. AVX2
+// is only reported if the OS also saves the upper halves of the registers.
+static unsigned cpu_features(void) {
+  if (cpu_feature_cache >= 0) return cpu_feature_cache;
+  unsigned features = 0;
+  const unsigned max_leaf = cpuid(0, 0).eax;
+  const struct cpuid leaf1 = cpuid(1, 0);
+  if (leaf1.edx & 1 << 26) features |= cpu_sse2;
+  if (leaf1.ecx & 1 << 23) features |= cpu_popcnt;
+  if (max_leaf >= 7) {
+    const struct cpuid leaf7 = cpuid(7, 0);
+    const bool os_saves_ymm =
+        (leaf1.ecx & 1 << 27) && (xgetbv(0) & 6) == 6;
+    if ((leaf1.ecx & 1 << 28) && os_saves_ymm && (leaf7.ebx & 1 << 5)) {
+      features |= cpu_avx2;
+    }
+    if (leaf7.ebx & 1 << 9) features |= cpu_erms;
+  }
+  cpu_feature_cache = features;
+  return features;
+}
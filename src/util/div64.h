@@ -0,0 +1,26 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// Division of a 64-bit integer by a 32-bit one without the __udivdi3 helper
+// (see division.h). On i386, divl divides edx:eax by a 32-bit divisor as long
+// as the quotient fits in 32 bits, so the dividend is divided one 32-bit half
+// at a time, as in long division, with the remainder carried into the second.
+
+// Divide *x by d in place and return the remainder.
+static unsigned div64_32(unsigned long long* x, unsigned d) {
+#ifdef __i386__
+  const unsigned high = *x >> 32;
+  unsigned low = *x, remainder;
+  asm("divl %4"
+      : "=a"(low), "=d"(remainder)
+      : "0"(low), "1"(high % d), "rm"(d));
+  *x = (unsigned long long)(high / d) << 32 | low;
+  return remainder;
+#else
+  const unsigned remainder = *x % d;
+  *x /= d;
+  return remainder;
+#endif
+}
@@ -1,42 +1,57 @@
 #pragma once
 
-// GCC automatically generates calls to __udivdi3 and __umoddi3 when attempting
-// division with `unsigned long long` variables, so we need to provide
-// a definition. However, it seems that these magic symbols don't get GC'd
-// properly when unused, so uncommenting this code causes all solvers to get
-// bigger.
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// GCC automatically generates calls to __udivdi3 and __umoddi3 when dividing
+// `unsigned long long` values on i386, so we need to provide a definition.
+// However, it seems that these magic symbols don't get GC'd properly when
+// unused, so only include this header in solvers which need them. For repeated
+// division by the same value, see divisor.h instead.
+
+#include "div64.h"
+
+#ifdef __i386__
+
+// Returns the number of leading zero bits in a non-zero 32-bit value.
+static int leading_zeros(unsigned x) {
+  return __builtin_clz(x);
+}
 
 struct divmod_result {
   unsigned long long quotient;
   unsigned long long remainder;
 };
 
-static __attribute__((pure)) struct divmod_result divmod(unsigned long long a,
-                                                         unsigned long long b) {
-  unsigned long long accumulator = 0;
-  unsigned long long value = b;
-  unsigned long long factor = 1;
-  while ((value << 1) <= a) {
-    value <<= 1;
-    factor <<= 1;
+// General 64-bit division (Hacker's Delight, divDU). If the divisor fits in 32
+// bits, this is just long division with divl. Otherwise, the quotient fits in
+// 32 bits and is estimated by dividing by the divisor's leading 32 bits.
+static struct divmod_result divmod(unsigned long long a, unsigned long long b) {
+  if (b >> 32 == 0) {
+    const unsigned remainder = div64_32(&a, b);
+    return (struct divmod_result){.quotient = a, .remainder = remainder};
   }
-  while (factor) {
-    if (value <= a) {
-      a -= value;
-      accumulator += factor;
-    }
-    value >>= 1;
-    factor >>= 1;
+  const int n = leading_zeros(b >> 32);
+  const unsigned normalized = (b << n) >> 32;
+  // Halve the dividend so that the quotient of the estimate fits in 32 bits.
+  unsigned long long estimate = a >> 1;
+  div64_32(&estimate, normalized);
+  unsigned long long quotient = (estimate << n) >> 31;
+  if (quotient) quotient--;
+  unsigned long long remainder = a - quotient * b;
+  if (remainder >= b) {
+    quotient++;
+    remainder -= b;
   }
-  return (struct divmod_result){.quotient = accumulator, .remainder = a};
+  return (struct divmod_result){.quotient = quotient, .remainder = remainder};
 }
 
-__attribute__((pure)) unsigned long long __udivdi3(unsigned long long a,
-                                                   unsigned long long b) {
+unsigned long long __udivdi3(unsigned long long a, unsigned long long b) {
   return divmod(a, b).quotient;
 }
 
-__attribute__((pure)) unsigned long long __umoddi3(unsigned long long a,
-                                                   unsigned long long b) {
+unsigned long long __umoddi3(unsigned long long a, unsigned long long b) {
   return divmod(a, b).remainder;
 }
+
+#endif  // __i386__
@@ -0,0 +1,68 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// Repeated division by the same 32-bit value. A `struct divisor` holds
+// a precomputed reciprocal so that each division costs a few multiplications
+// (Barrett reduction) instead of a division, which on i386 would otherwise be
+// a pair of divl instructions (see div64.h) or worse.
+
+#include "div64.h"
+
+// Returns the high 64 bits of the 128-bit product a * b.
+static unsigned long long mul_high64(unsigned long long a,
+                                     unsigned long long b) {
+#ifdef __x86_64__
+  return (__extension__(unsigned __int128)a * b) >> 64;
+#else
+  // Schoolbook multiplication with 32-bit digits.
+  const unsigned a_low = a, a_high = a >> 32, b_low = b, b_high = b >> 32;
+  const unsigned long long low = (unsigned long long)a_low * b_low;
+  const unsigned long long middle1 = (unsigned long long)a_high * b_low;
+  const unsigned long long middle2 = (unsigned long long)a_low * b_high;
+  const unsigned long long high = (unsigned long long)a_high * b_high;
+  const unsigned long long carry =
+      (low >> 32) + (unsigned)middle1 + (unsigned)middle2;
+  return high + (middle1 >> 32) + (middle2 >> 32) + (carry >> 32);
+#endif
+}
+
+struct divisor {
+  unsigned value;
+  // floor((2^64 - 1) / value).
+  unsigned long long reciprocal;
+};
+
+static struct divisor divisor_init(unsigned value) {
+  unsigned long long reciprocal = -1;
+  div64_32(&reciprocal, value);
+  return (struct divisor){.value = value, .reciprocal = reciprocal};
+}
+
+// Returns x / d and stores x % d in *remainder. The estimated quotient
+// x * reciprocal / 2^64 is never more than one too small.
+static unsigned long long divisor_divmod(const struct divisor* d,
+                                         unsigned long long x,
+                                         unsigned* remainder) {
+  unsigned long long quotient = mul_high64(x, d->reciprocal);
+  unsigned long long r = x - quotient * d->value;
+  if (r >= d->value) {
+    quotient++;
+    r -= d->value;
+  }
+  *remainder = r;
+  return quotient;
+}
+
+static unsigned divisor_mod(const struct divisor* d, unsigned long long x) {
+  unsigned remainder;
+  divisor_divmod(d, x, &remainder);
+  return remainder;
+}
+
+// Returns a * b mod d, for a, b < d.
+static unsigned divisor_mod_mul(const struct divisor* d, unsigned a,
+                                unsigned b) {
+  return divisor_mod(d, (unsigned long long)a * b);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// The process's view of its own ELF image. On entry, the stack holds argc, the
+// argv pointers, the environment pointers and then the auxiliary vector, which
+// says where the kernel loaded the program headers.
+
+#define AT_PHDR 3
+#define AT_PHNUM 5
+#define PT_LOAD 1
+#define PF_W 2
+
+#ifdef __x86_64__
+struct program_header {
+  unsigned type, flags;
+  unsigned long offset, address, physical_address, file_size, memory_size,
+      align;
+};
+#else
+struct program_header {
+  unsigned type, offset, address, physical_address, file_size, memory_size,
+      flags, align;
+};
+#endif
+
+// Returns the environment, given the initial stack pointer.
+static char** initial_environment(long* stack) {
+  return (char**)(stack + 1) + stack[0] + 1;
+}
+
+// Returns the program headers, given the initial stack pointer, and sets
+// *count to their number.
+static const struct program_header* program_headers(long* stack, int* count) {
+  char** envp = initial_environment(stack);
+  while (*envp) envp++;
+  const struct program_header* headers = NULL;
+  *count = 0;
+  for (unsigned long* aux = (unsigned long*)(envp + 1); aux[0]; aux += 2) {
+    if (aux[0] == AT_PHDR) headers = (const struct program_header*)aux[1];
+    if (aux[0] == AT_PHNUM) *count = aux[1];
+  }
+  return headers;
+}
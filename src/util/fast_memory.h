@@ -0,0 +1,162 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// Vectorized memory primitives, used by memcpy.h, memmove.h, and memset.h when
+// building with -DFAST_MEMORY. The first call through any of the function
+// pointers below checks the CPU once and points all of them at the widest
+// variant that it supports: AVX2, SSE2, or the plain byte loops. On CPUs with
+// enhanced rep movsb/stosb, large blocks are handed to the string instructions
+// instead, since they outrun explicit loops once their startup cost has been
+// amortized.
+
+#include "cpuid.h"
+
+// Unaligned vectors which may alias anything.
+typedef char memory_v16
+    __attribute__((vector_size(16), aligned(1), may_alias));
+typedef char memory_v32
+    __attribute__((vector_size(32), aligned(1), may_alias));
+
+// Blocks of at least this many bytes use rep movsb/stosb, if it is fast.
+enum { memory_rep_threshold = 2048 };
+static size_t memory_rep_min = -1;
+
+static void memory_rep_movsb(char* dest, const char* src, size_t n) {
+  asm volatile("rep movsb" : "+D"(dest), "+S"(src), "+c"(n) : : "memory");
+}
+
+static void memory_rep_stosb(char* dest, int c, size_t n) {
+  asm volatile("rep stosb" : "+D"(dest), "+c"(n) : "a"(c) : "memory");
+}
+
+// Copying forwards is also correct for overlapping regions with dest < src.
+static void memory_copy_bytes(char* dest, const char* src, size_t n) {
+  char* const end = dest + n;
+  while (dest != end) *dest++ = *src++;
+}
+
+// Copying backwards is correct for overlapping regions with dest > src.
+static void memory_copy_backward_bytes(char* dest, const char* src, size_t n) {
+  while (n) {
+    n--;
+    dest[n] = src[n];
+  }
+}
+
+static void memory_fill_bytes(char* dest, int c, size_t n) {
+  char* const end = dest + n;
+  while (dest != end) *dest++ = c;
+}
+
+// Each vector is loaded in full before it is stored, so the vector loops are
+// safe for overlapping regions in the same direction as the byte loops.
+__attribute__((target("sse2")))
+static void memory_copy_sse2(char* dest, const char* src, size_t n) {
+  if (n >= memory_rep_min) {
+    memory_rep_movsb(dest, src, n);
+    return;
+  }
+  for (; n >= 16; n -= 16, dest += 16, src += 16) {
+    *(memory_v16*)dest = *(const memory_v16*)src;
+  }
+  memory_copy_bytes(dest, src, n);
+}
+
+__attribute__((target("sse2")))
+static void memory_copy_backward_sse2(char* dest, const char* src, size_t n) {
+  for (; n >= 16; n -= 16) {
+    *(memory_v16*)(dest + n - 16) = *(const memory_v16*)(src + n - 16);
+  }
+  memory_copy_backward_bytes(dest, src, n);
+}
+
+__attribute__((target("sse2")))
+static void memory_fill_sse2(char* dest, int c, size_t n) {
+  if (n >= memory_rep_min) {
+    memory_rep_stosb(dest, c, n);
+    return;
+  }
+  memory_v16 v = {0};
+  v += (char)c;
+  for (; n >= 16; n -= 16, dest += 16) *(memory_v16*)dest = v;
+  memory_fill_bytes(dest, c, n);
+}
+
+__attribute__((target("avx2")))
+static void memory_copy_avx2(char* dest, const char* src, size_t n) {
+  if (n >= memory_rep_min) {
+    memory_rep_movsb(dest, src, n);
+    return;
+  }
+  for (; n >= 32; n -= 32, dest += 32, src += 32) {
+    *(memory_v32*)dest = *(const memory_v32*)src;
+  }
+  memory_copy_bytes(dest, src, n);
+}
+
+__attribute__((target("avx2")))
+static void memory_copy_backward_avx2(char* dest, const char* src, size_t n) {
+  for (; n >= 32; n -= 32) {
+    *(memory_v32*)(dest + n - 32) = *(const memory_v32*)(src + n - 32);
+  }
+  memory_copy_backward_bytes(dest, src, n);
+}
+
+__attribute__((target("avx2")))
+static void memory_fill_avx2(char* dest, int c, size_t n) {
+  if (n >= memory_rep_min) {
+    memory_rep_stosb(dest, c, n);
+    return;
+  }
+  memory_v32 v = {0};
+  v += (char)c;
+  for (; n >= 32; n -= 32, dest += 32) *(memory_v32*)dest = v;
+  memory_fill_bytes(dest, c, n);
+}
+
+static void memory_copy_resolve(char* dest, const char* src, size_t n);
+static void memory_copy_backward_resolve(char* dest, const char* src,
+                                         size_t n);
+static void memory_fill_resolve(char* dest, int c, size_t n);
+
+static void (*memory_copy)(char* dest, const char* src, size_t n) =
+    memory_copy_resolve;
+static void (*memory_copy_backward)(char* dest, const char* src, size_t n) =
+    memory_copy_backward_resolve;
+static void (*memory_fill)(char* dest, int c, size_t n) = memory_fill_resolve;
+
+static void memory_select(void) {
+  const unsigned features = cpu_features();
+  if (features & cpu_erms) memory_rep_min = memory_rep_threshold;
+  if (features & cpu_avx2) {
+    memory_copy = memory_copy_avx2;
+    memory_copy_backward = memory_copy_backward_avx2;
+    memory_fill = memory_fill_avx2;
+  } else if (features & cpu_sse2) {
+    memory_copy = memory_copy_sse2;
+    memory_copy_backward = memory_copy_backward_sse2;
+    memory_fill = memory_fill_sse2;
+  } else {
+    memory_copy = memory_copy_bytes;
+    memory_copy_backward = memory_copy_backward_bytes;
+    memory_fill = memory_fill_bytes;
+  }
+}
+
+static void memory_copy_resolve(char* dest, const char* src, size_t n) {
+  memory_select();
+  memory_copy(dest, src, n);
+}
+
+static void memory_copy_backward_resolve(char* dest, const char* src,
+                                         size_t n) {
+  memory_select();
+  memory_copy_backward(dest, src, n);
+}
+
+static void memory_fill_resolve(char* dest, int c, size_t n) {
+  memory_select();
+  memory_fill(dest, c, n);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// System calls for working with file descriptors beyond stdin and stdout. Like
+// the raw system calls, these return a negative error code on failure.
+
+#include "die.h"
+
+#define O_RDONLY 0
+#define O_WRONLY 1
+#define O_CREAT 0100
+#define O_APPEND 02000
+
+#define SEEK_SET 0
+#define SEEK_CUR 1
+
+static int open(const char* path, int flags, int mode) {
+  return syscall3(SYS_open, (long)path, flags, mode);
+}
+
+static int close(int fd) {
+  return syscall1(SYS_close, fd);
+}
+
+static long lseek(int fd, long offset, int whence) {
+  return syscall3(SYS_lseek, fd, offset, whence);
+}
+
+static int dup(int fd) {
+  return syscall1(SYS_dup, fd);
+}
+
+static int dup2(int fd, int new_fd) {
+  return syscall2(SYS_dup2, fd, new_fd);
+}
+
+static long sendfile(int out_fd, int in_fd, long* offset, size_t count) {
+  return syscall4(SYS_sendfile, out_fd, in_fd, (long)offset, count);
+}
+
+// Create an anonymous in-memory file.
+static int memfd_create(const char* name) {
+  return syscall2(SYS_memfd_create, (long)name, 0);
+}
+
+// Write all of the given data, retrying after short writes.
+static void write_all(int fd, const char* data, size_t size) {
+  while (size) {
+    const ssize_t len = write(fd, data, size);
+    if (len <= 0) die("write");
+    data += len;
+    size -= len;
+  }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// Decimal formatting of unsigned integers. 64-bit values are split into chunks
+// of nine digits with div64.h so that the digits themselves are produced with
+// 32-bit arithmetic. Unless optimizing for size, digits are produced two at
+// a time from a lookup table.
+
+#include "div64.h"
+
+#ifndef __OPTIMIZE_SIZE__
+static const char digit_pairs[200] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536"
+    "37383940414243444546474849505152535455565758596061626364656667686970717273"
+    "7475767778798081828384858687888990919293949596979899";
+#endif
+
+// Write the digits of x backwards, ending just before `end`, and return the
+// address of the first digit. At least one digit is always written.
+static char* format_digits(char* end, unsigned x) {
+  char* i = end;
+#ifdef __OPTIMIZE_SIZE__
+  do {
+    *--i = '0' + x % 10;
+    x /= 10;
+  } while (x);
+#else
+  while (x >= 100) {
+    const char* const pair = &digit_pairs[2 * (x % 100)];
+    x /= 100;
+    *--i = pair[1];
+    *--i = pair[0];
+  }
+  if (x >= 10) {
+    *--i = digit_pairs[2 * x + 1];
+    *--i = digit_pairs[2 * x];
+  } else {
+    *--i = '0' + x;
+  }
+#endif
+  return i;
+}
+
+// Format x in decimal at o, returning the address after the last digit.
+static char* format_u32(char* o, unsigned x) {
+  char buffer[10];
+  char* const end = buffer + sizeof(buffer);
+  for (const char* i = format_digits(end, x); i != end; i++) *o++ = *i;
+  return o;
+}
+
+// Format x in decimal at o, returning the address after the last digit. This
+// writes at most 20 characters.
+static char* format_u64(char* o, unsigned long long x) {
+  char buffer[20];
+  char* const end = buffer + sizeof(buffer);
+  char* i = end;
+  // Peel off nine digits at a time until the rest fits in 32 bits. These
+  // chunks are in the middle of the number, so they keep their leading zeros.
+  while (x >> 32) {
+    char* const chunk_start = i - 9;
+    i = format_digits(i, div64_32(&x, 1000000000));
+    while (i != chunk_start) *--i = '0';
+  }
+  for (i = format_digits(i, x); i != end; i++) *o++ = *i;
+  return o;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+// System call for getting information about an open file.
+
+#ifdef __x86_64__
+// Layout of the kernel's `struct stat` for x86_64.
+struct stat {
+  unsigned long st_dev;
+  unsigned long st_ino;
+  unsigned long st_nlink;
+  unsigned st_mode;
+  unsigned st_uid;
+  unsigned st_gid;
+  unsigned pad0;
+  unsigned long st_rdev;
+  long st_size;
+  long st_blksize;
+  long st_blocks;
+  unsigned long st_atime, st_atime_nsec;
+  unsigned long st_mtime, st_mtime_nsec;
+  unsigned long st_ctime, st_ctime_nsec;
+  long unused[3];
+};
+#else
+// Layout of the kernel's `struct stat64` for i386, which is what fstat fills
+// in here since it uses the fstat64 system call.
+struct stat {
+  unsigned long long st_dev;
+  unsigned char pad0[4];
+  unsigned st_ino_low;
+  unsigned st_mode;
+  unsigned st_nlink;
+  unsigned st_uid;
+  unsigned st_gid;
+  unsigned long long st_rdev;
+  unsigned char pad3[4];
+  long long st_size;
+  unsigned st_blksize;
+  unsigned long long st_blocks;
+  unsigned st_atime, st_atime_nsec;
+  unsigned st_mtime, st_mtime_nsec;
+  unsigned st_ctime, st_ctime_nsec;
+  unsigned long long st_ino;
+};
+#endif
+
+#define S_IFMT 0170000
+#define S_IFREG 0100000
+#define S_ISREG(mode) (((mode) & S_IFMT) == S_IFREG)
+
+static int fstat(unsigned int fd, struct stat* result) {
+  return syscall2(SYS_fstat, fd, (long)result);
+}
@@ -4,16 +4,11 @@
 
 struct timeval {
   // Current time in seconds.
-  unsigned tv_sec;
+  long tv_sec;
   // Microseconds.
-  unsigned tv_usec;
+  long tv_usec;
 };
 
 static int gettimeofday(struct timeval* restrict tp, void* restrict tzp) {
-  int result;
-  asm volatile("int $0x80"
-               : "=a"(result)
-               : "a"(78), "b"(tp), "c"(tzp)
-               : "memory");
-  return result;
+  return syscall2(SYS_gettimeofday, (long)tp, (long)tzp);
 }
@@ -0,0 +1,78 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// Large tables for solvers which access them at random. In .bss, such a table is
+// faulted in one 4 KiB page at a time and then thrashes the TLB. huge_alloc
+// instead places it in the arena, aligned to a 2 MiB boundary and marked with
+// MADV_HUGEPAGE, so that the kernel backs it with transparent huge pages
+// wherever it can. Tables smaller than a huge page are ordinary arena
+// allocations. Building with -DPREFAULT also touches every page of a huge table
+// up front, which takes the page faults out of the solver's hot loop.
+//
+// With -DTRACE, the size of each table and how much of it was actually touched
+// are reported on exit along with the phases.
+
+#include "arena.h"
+#include "mmap.h"
+
+enum { huge_page_size = 2 << 20 };
+
+#ifdef TRACE
+
+#include "printf.h"
+
+enum { max_huge_tables = 4 };
+static struct {
+  char* address;
+  size_t size;
+} huge_tables[max_huge_tables];
+static int num_huge_tables;
+
+// Called by write_trace in util/trace.h, through a weak reference.
+void write_huge_pages_trace(void) {
+  for (int i = 0; i < num_huge_tables; i++) {
+    // Count the resident pages a chunk at a time.
+    unsigned char resident[4096];
+    size_t touched = 0;
+    for (size_t offset = 0; offset < huge_tables[i].size;) {
+      const size_t pages = (huge_tables[i].size - offset) / page_size;
+      const size_t n = pages < sizeof(resident) ? pages : sizeof(resident);
+      if (mincore(huge_tables[i].address + offset, n * page_size, resident)) {
+        break;
+      }
+      for (size_t j = 0; j < n; j++) touched += resident[j] & 1;
+      offset += n * page_size;
+    }
+    fprintf(stderr, "trace: huge table %u KiB, %u KiB touched\n",
+            (unsigned)(huge_tables[i].size >> 10),
+            (unsigned)(touched * (page_size >> 10)));
+  }
+}
+
+#endif
+
+// Allocate a zeroed table of `size` bytes. A table smaller than a huge page
+// gains nothing from one, and rounding it up would fault in and zero a whole
+// 2 MiB page, so it is an ordinary arena allocation.
+static void* huge_alloc(size_t size) {
+  if (size < huge_page_size) return arena_alloc(size, 16);
+  size = (size + huge_page_size - 1) & -huge_page_size;
+  char* const table = arena_alloc(size, huge_page_size);
+  madvise(table, size, MADV_HUGEPAGE);
+#ifdef PREFAULT
+  for (size_t i = 0; i < size; i += page_size) table[i] = 0;
+#endif
+#ifdef TRACE
+  if (num_huge_tables < max_huge_tables) {
+    huge_tables[num_huge_tables].address = table;
+    huge_tables[num_huge_tables].size = size;
+    num_huge_tables++;
+  }
+#endif
+  return table;
+}
+
+// Allocate a table of `count` objects of the given type.
+#define HUGE_ALLOC(type, count) ((type*)huge_alloc(sizeof(type) * (count)))
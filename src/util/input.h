@@ -0,0 +1,99 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// A streaming reader for stdin. Data is read in bounded chunks into a fixed
+// buffer, so inputs of any size can be processed in constant memory. The
+// reader hands out complete lines (or tokens) that are contiguous in memory,
+// even if they straddled a chunk boundary when they were read, so callers can
+// parse them with the same pointer-based helpers as a fully buffered input.
+//
+// Lines must fit in the buffer: a line longer than input_chunk_size is an
+// error. As with the fully buffered solvers, the input must end in a newline.
+
+#include "die.h"
+#include "memmove.h"
+
+enum { input_chunk_size = 65536 };
+
+struct input {
+  // The unconsumed data is [begin, end).
+  char* begin;
+  char* end;
+  bool eof;
+  char buffer[input_chunk_size];
+};
+
+// Move the unconsumed data to the start of the buffer and read more data after
+// it. Returns false if no more data could be read.
+static bool input_fill(struct input* in) {
+  if (in->eof) return false;
+  const int remaining = in->end - in->begin;
+  if (in->begin != in->buffer) {
+    // memmove does not support empty ranges.
+    if (remaining) memmove(in->buffer, in->begin, remaining);
+    in->begin = in->buffer;
+    in->end = in->buffer + remaining;
+  }
+  if (remaining == input_chunk_size) die("line too long");
+  const int space = in->buffer + input_chunk_size - in->end;
+  const int len = read(STDIN_FILENO, in->end, space);
+  if (len < 0) die("read");
+  if (len == 0) {
+    in->eof = true;
+    return false;
+  }
+  in->end += len;
+  return true;
+}
+
+// Find the first byte at or after `i` for which `is_end` is true, reading more
+// data as necessary. Returns the offset of that byte from in->begin.
+static int input_scan(struct input* in, int i, bool (*is_end)(char)) {
+  while (true) {
+    for (const char* const end = in->end; in->begin + i != end; i++) {
+      if (is_end(in->begin[i])) return i;
+    }
+    if (!input_fill(in)) {
+      if (i) die("newline");
+      return -1;
+    }
+  }
+}
+
+static bool input_is_newline(char c) {
+  return c == '\n';
+}
+
+// Read the next line. On success, returns a pointer to the start of the line
+// and sets *length to the number of characters before the terminating newline,
+// which is guaranteed to be present at line[*length]. The line remains valid
+// until the next call to any input_* function. Returns NULL at the end of the
+// input.
+static char* input_line(struct input* in, int* length) {
+  const int n = input_scan(in, 0, input_is_newline);
+  if (n < 0) return NULL;
+  char* const line = in->begin;
+  in->begin += n + 1;
+  *length = n;
+  return line;
+}
+
+static bool input_is_delimiter(char c) {
+  return c == ' ' || c == ',' || c == '\n';
+}
+
+// Read the next token, where tokens are separated by spaces, commas, or
+// newlines. On success, returns a pointer to the token and sets *length to its
+// length: the delimiter that ended the token is at token[*length], and it is
+// consumed along with the token. Empty tokens are returned between adjacent
+// delimiters. Returns NULL at the end of the input.
+static char* input_token(struct input* in, int* length) {
+  const int n = input_scan(in, 0, input_is_delimiter);
+  if (n < 0) return NULL;
+  char* const token = in->begin;
+  in->begin += n + 1;
+  *length = n;
+  return token;
+}
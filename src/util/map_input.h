@@ -0,0 +1,88 @@
+#pragma once
+
+// Acquire the whole of stdin as a single buffer. If stdin is a regular file, it
+// is mapped directly from the page cache instead of being copied. Otherwise
+// (e.g. for a pipe), it is read into an anonymous mapping which grows as
+// needed. Either way, there is no fixed upper limit on the input size.
+//
+// The buffer is followed by at least input_padding zero bytes, so parsers which
+// work on a whole word (or vector) at a time may read past the end of the input
+// without faulting.
+
+#include "die.h"
+#include "fstat.h"
+#include "mmap.h"
+
+enum { input_padding = 64 };
+
+#ifdef BATCH
+// Defined by util/batch.h, which unmaps the input before the next record.
+static void batch_input_mapped(void* address, size_t size);
+#endif
+
+// Round a size up to a whole number of pages.
+static size_t round_to_pages(size_t size) {
+  return (size + page_size - 1) & -page_size;
+}
+
+static char* map_regular_input(size_t length) {
+  // Reserve an anonymous region with space for the padding and then map the
+  // file over the start of it. The kernel zeroes the rest of the file's last
+  // page, and any padding beyond that comes from the anonymous pages.
+  const size_t size = round_to_pages(length + input_padding);
+  char* const buffer = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (map_failed(buffer)) die("mmap");
+  // The mapping is private, so solvers which modify the input in place only
+  // copy the pages that they touch.
+  const void* const file = mmap(buffer, length, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_FIXED, STDIN_FILENO, 0);
+  if (map_failed(file)) die("mmap");
+  madvise(buffer, length, MADV_SEQUENTIAL);
+#ifdef BATCH
+  batch_input_mapped(buffer, size);
+#endif
+  return buffer;
+}
+
+static char* read_piped_input(size_t* length) {
+  size_t capacity = 65536, size = 0;
+  char* buffer = mmap(NULL, capacity, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (map_failed(buffer)) die("mmap");
+  while (true) {
+    // Always leave space for the padding.
+    if (capacity - size <= input_padding) {
+      buffer = mremap(buffer, capacity, 2 * capacity, MREMAP_MAYMOVE);
+      if (map_failed(buffer)) die("mremap");
+      capacity *= 2;
+    }
+    const int len =
+        read(STDIN_FILENO, buffer + size, capacity - input_padding - size);
+    if (len < 0) die("read");
+    if (len == 0) break;
+    size += len;
+  }
+#ifdef BATCH
+  batch_input_mapped(buffer, capacity);
+#endif
+  *length = size;
+  return buffer;
+}
+
+// Returns a writable buffer holding all of stdin and sets *length to its size.
+// The buffer is always followed by zero padding. A regular file is mapped from
+// its beginning, regardless of the current offset of stdin.
+static char* map_input(int* length) {
+  struct stat info;
+  if (fstat(STDIN_FILENO, &info) == 0 && S_ISREG(info.st_mode) &&
+      info.st_size > 0) {
+    if (info.st_size > 0x7FFFFFFF - page_size) die("too big");
+    *length = info.st_size;
+    return map_regular_input(info.st_size);
+  }
+  size_t size;
+  char* const buffer = read_piped_input(&size);
+  *length = size;
+  return buffer;
+}
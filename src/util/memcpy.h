@@ -1,11 +1,19 @@
 #pragma once
 
+#ifdef FAST_MEMORY
+#include "fast_memory.h"
+#endif
+
 // Copy n bytes from src to dest. Return dest. The src and dest regions must not
 // overlap.
 static void* memcpy(void* restrict dest, const void* restrict src, size_t n) {
+#ifdef FAST_MEMORY
+  memory_copy(dest, src, n);
+#else
   char* o = dest;
   char* const end = o + n;
   const char* i = src;
   while (o != end) *o++ = *i++;
+#endif
   return dest;
 }
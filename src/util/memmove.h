@@ -1,7 +1,20 @@
 #pragma once
 
+#ifdef FAST_MEMORY
+#include "fast_memory.h"
+#endif
+
 // Copy n bytes from src to dest. The src and dest regions may overlap.
 void* memmove(void* dest, const void* src, size_t n) {
+#ifdef FAST_MEMORY
+  // Copy forwards unless dest lies inside the source region.
+  if ((size_t)((char*)dest - (const char*)src) >= n) {
+    memory_copy(dest, src, n);
+  } else {
+    memory_copy_backward(dest, src, n);
+  }
+  return dest;
+#else
   if (dest < src) {
     char* o = dest;
     char* const end = o + n;
@@ -12,9 +25,8 @@ void* memmove(void* dest, const void* src, size_t n) {
     char* const end = dest;
     char* o = end + n;
     const char* i = (const char*)src + n;
-    do {
-      *--o = *--i;
-    } while (o != end);
+    while (o != end) *--o = *--i;
     return dest;
   }
+#endif
 }
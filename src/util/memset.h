@@ -5,10 +5,18 @@
 // functions that cannot be removed due to subsequent linker errors.
 #pragma GCC system_header
 
+#ifdef FAST_MEMORY
+#include "fast_memory.h"
+#endif
+
 // Fill n bytes of memory starting at dest with copies of c.
 static void* memset(void* dest, int c, size_t n) {
+#ifdef FAST_MEMORY
+  memory_fill(dest, c, n);
+#else
   unsigned char* o = dest;
   unsigned char* const end = o + n;
   while (o != end) *o++ = c;
+#endif
   return dest;
 }
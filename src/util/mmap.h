@@ -0,0 +1,57 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// System calls for managing memory mappings. Like the raw system calls, these
+// return a negative error code on failure. For the functions which return an
+// address, this is any value in the last page of the address space.
+
+#define PROT_READ 1
+#define PROT_WRITE 2
+#define MAP_PRIVATE 2
+#define MAP_FIXED 0x10
+#define MAP_ANONYMOUS 0x20
+#define MREMAP_MAYMOVE 1
+#define MADV_SEQUENTIAL 2
+#define MADV_DONTNEED 4
+#define MADV_HUGEPAGE 14
+
+enum { page_size = 4096 };
+
+// Returns true if the given address is an error code from a system call.
+static bool map_failed(const void* address) {
+  return (unsigned long)address > -(unsigned long)page_size;
+}
+
+// Map `length` bytes of the given file, starting from page `page_offset`.
+static void* mmap(void* address, size_t length, int protection, int flags,
+                  int fd, unsigned page_offset) {
+#ifdef __x86_64__
+  // The x86_64 system call takes the offset in bytes.
+  const long offset = (long)page_offset * page_size;
+#else
+  const long offset = page_offset;
+#endif
+  return (void*)syscall6(SYS_mmap, (long)address, length, protection, flags,
+                         fd, offset);
+}
+
+static int munmap(void* address, size_t length) {
+  return syscall2(SYS_munmap, (long)address, length);
+}
+
+static void* mremap(void* address, size_t old_length, size_t new_length,
+                    int flags) {
+  return (void*)syscall4(SYS_mremap, (long)address, old_length, new_length,
+                         flags);
+}
+
+static int madvise(void* address, size_t length, int advice) {
+  return syscall3(SYS_madvise, (long)address, length, advice);
+}
+
+// Set vec[i] to 1 if page i of the given range is resident, and 0 otherwise.
+static int mincore(void* address, size_t length, unsigned char* vec) {
+  return syscall3(SYS_mincore, (long)address, length, (long)vec);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// A process-wide buffer for stdout. All of the print helpers append to this
+// buffer instead of issuing their own write calls. The buffer is flushed when
+// it fills up, when flush_output is called explicitly, and on exit.
+
+enum { output_buffer_size = 8192 };
+static char output_buffer[output_buffer_size];
+static int output_size;
+
+// Write out all buffered output. This is not static so that exit() can find it
+// via a weak reference in the prelude.
+void flush_output(void) {
+  const char* i = output_buffer;
+  const char* const end = output_buffer + output_size;
+  while (i != end) {
+    const int len = write(STDOUT_FILENO, i, end - i);
+    if (len <= 0) break;
+    i += len;
+  }
+  output_size = 0;
+}
+
+// Returns a pointer to space for at least n bytes of output, flushing the
+// buffer first if there is not enough space. n must not exceed the buffer size.
+// Once written, the output is committed with output_commit.
+static char* output_reserve(int n) {
+  if (output_buffer_size - output_size < n) flush_output();
+  return output_buffer + output_size;
+}
+
+// Commit the output that has been written to the space returned by
+// output_reserve, up to (but not including) `end`.
+static void output_commit(char* end) {
+  output_size = end - output_buffer;
+}
+
+// Append n bytes to the output.
+static void output_write(const void* data, size_t n) {
+  if (output_buffer_size - output_size < n) {
+    flush_output();
+    // Output which is too large to buffer is written directly.
+    if (n > output_buffer_size) {
+      write(STDOUT_FILENO, data, n);
+      return;
+    }
+  }
+  memcpy(output_buffer + output_size, data, n);
+  output_size += n;
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// A work-stealing scheduler for data-parallel loops. The first call to
+// parallel_for starts one worker thread per available CPU (up to max_workers,
+// counting the calling thread as worker 0). Each worker owns a Chase-Lev deque
+// of index ranges: it repeatedly splits its current range in half, pushing the
+// upper half onto the bottom of its deque for others to steal from the top,
+// until the range is no larger than the grain size, and then runs it. Idle
+// workers sleep on a futex between loops. Everything is statically allocated.
+
+#include "die.h"
+#include "popcount.h"
+#include "thread.h"
+
+enum { max_workers = 8, deque_capacity = 64 };
+
+struct loop_range {
+  int begin, end;
+};
+
+// The owner pushes and pops at the bottom; thieves steal from the top. Indices
+// increase monotonically and are reduced modulo the capacity on access. Since
+// each split halves a range, a deque never holds more than 32 ranges.
+struct deque {
+  int top, bottom;
+  struct loop_range ranges[deque_capacity];
+} __attribute__((aligned(64)));
+
+// Per-worker partial results for parallel_sum, padded to avoid false sharing.
+struct partial_sum {
+  unsigned long long value;
+} __attribute__((aligned(64)));
+
+static struct {
+  int num_workers;
+  // Incremented to start each loop. Sleeping workers wait for it to change.
+  int generation;
+  // The number of loop iterations which have not yet finished.
+  int remaining;
+  int grain;
+  void* context;
+  void (*fn)(void* context, int begin, int end);
+  unsigned long long (*sum_fn)(void* context, int begin, int end);
+  struct deque deques[max_workers];
+  struct partial_sum sums[max_workers];
+  struct thread threads[max_workers];
+} pool;
+
+static void deque_push(struct deque* d, struct loop_range r) {
+  const int b = d->bottom;
+  if (b - atomic_load(&d->top) == deque_capacity) die("deque overflow");
+  d->ranges[b % deque_capacity] = r;
+  atomic_store(&d->bottom, b + 1);
+}
+
+static bool deque_pop(struct deque* d, struct loop_range* r) {
+  const int b = d->bottom - 1;
+  atomic_store(&d->bottom, b);
+  int t = atomic_load(&d->top);
+  if (t > b) {
+    atomic_store(&d->bottom, b + 1);
+    return false;
+  }
+  *r = d->ranges[b % deque_capacity];
+  if (t != b) return true;
+  // This is the last range, so we must race any thieves for it.
+  const bool won = atomic_compare_exchange(&d->top, &t, t + 1);
+  atomic_store(&d->bottom, b + 1);
+  return won;
+}
+
+static bool deque_steal(struct deque* d, struct loop_range* r) {
+  int t = atomic_load(&d->top);
+  const int b = atomic_load(&d->bottom);
+  if (t >= b) return false;
+  *r = d->ranges[t % deque_capacity];
+  return atomic_compare_exchange(&d->top, &t, t + 1);
+}
+
+// Run a range on worker w, splitting off halves for other workers to steal.
+static void pool_execute(int w, struct loop_range r) {
+  while (r.end - r.begin > pool.grain) {
+    const int middle = r.begin + (r.end - r.begin) / 2;
+    deque_push(&pool.deques[w], (struct loop_range){middle, r.end});
+    r.end = middle;
+  }
+  if (pool.sum_fn) {
+    pool.sums[w].value += pool.sum_fn(pool.context, r.begin, r.end);
+  } else {
+    pool.fn(pool.context, r.begin, r.end);
+  }
+  atomic_fetch_add(&pool.remaining, -(r.end - r.begin));
+}
+
+// Participate in the current loop as worker w until it is finished.
+static void pool_run(int w) {
+  int failures = 0;
+  while (atomic_load(&pool.remaining)) {
+    struct loop_range r = {0, 0};
+    bool found = deque_pop(&pool.deques[w], &r);
+    for (int i = 1; !found && i < pool.num_workers; i++) {
+      found = deque_steal(&pool.deques[(w + i) % pool.num_workers], &r);
+    }
+    if (found) {
+      pool_execute(w, r);
+      failures = 0;
+    } else if (++failures % 64) {
+      cpu_relax();
+    } else {
+      // Persistent failure suggests that the workers with outstanding ranges
+      // aren't running, so let them have the CPU.
+      thread_yield();
+    }
+  }
+}
+
+static void pool_worker(void* deque) {
+  const int w = (struct deque*)deque - pool.deques;
+  int generation = 0;
+  while (true) {
+    const int next = atomic_load(&pool.generation);
+    if (next == generation) {
+      futex_wait(&pool.generation, generation);
+      continue;
+    }
+    generation = next;
+    pool_run(w);
+  }
+}
+
+// Returns the number of CPUs that this process may run on.
+static int available_cpus(void) {
+  unsigned mask[32];
+  const int length =
+      syscall3(SYS_sched_getaffinity, 0, sizeof(mask), (long)mask);
+  if (length <= 0) return 1;
+  int count = 0;
+  for (int i = 0; i < length / 4; i++) count += popcount(mask[i]);
+  return count;
+}
+
+static void pool_start(void) {
+#ifdef BATCH
+  // Worker threads would outlive the state which util/batch.h resets between
+  // records, so batch mode runs every loop on the calling thread.
+  const int cpus = 1;
+#else
+  const int cpus = available_cpus();
+#endif
+  pool.num_workers = cpus < max_workers ? cpus : max_workers;
+  for (int w = 1; w < pool.num_workers; w++) {
+    thread_spawn(&pool.threads[w], pool_worker, &pool.deques[w]);
+  }
+}
+
+static void pool_loop(int begin, int end, int grain) {
+  if (begin >= end) return;
+  if (pool.num_workers == 0) pool_start();
+  pool.grain = grain < 1 ? 1 : grain;
+  deque_push(&pool.deques[0], (struct loop_range){begin, end});
+  atomic_store(&pool.remaining, end - begin);
+  if (pool.num_workers > 1) {
+    atomic_fetch_add(&pool.generation, 1);
+    futex_wake(&pool.generation, max_workers);
+  }
+  pool_run(0);
+}
+
+// Call fn(context, i, j) for disjoint subranges [i, j) which together cover
+// [begin, end), in parallel. Each subrange has at most `grain` elements.
+// Returns once every call has returned.
+static void parallel_for(int begin, int end, int grain,
+                         void (*fn)(void* context, int begin, int end),
+                         void* context) {
+  pool.fn = fn;
+  pool.sum_fn = NULL;
+  pool.context = context;
+  pool_loop(begin, end, grain);
+}
+
+// Like parallel_for, except that fn returns a result for its subrange and the
+// sum of these results is returned.
+static unsigned long long parallel_sum(
+    int begin, int end, int grain,
+    unsigned long long (*fn)(void* context, int begin, int end),
+    void* context) {
+  pool.sum_fn = fn;
+  pool.context = context;
+  for (int w = 0; w < max_workers; w++) pool.sums[w].value = 0;
+  pool_loop(begin, end, grain);
+  unsigned long long total = 0;
+  for (int w = 0; w < max_workers; w++) total += pool.sums[w].value;
+  return total;
+}
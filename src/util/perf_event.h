@@ -0,0 +1,114 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// Hardware performance counters via perf_event_open. Each counter is opened
+// separately for the calling thread, user space only, so that a counter which
+// the machine or kernel doesn't support (as in many virtual machines) can be
+// left out without losing the rest. Threads started later are not counted.
+
+// A prefix of the kernel's struct perf_event_attr (PERF_ATTR_SIZE_VER0), which
+// has the same layout on i386 and x86_64.
+struct perf_event_attr {
+  unsigned type;
+  unsigned size;
+  unsigned long long config;
+  unsigned long long sample_period;
+  unsigned long long sample_type;
+  unsigned long long read_format;
+  // A bit field in the kernel's definition; see the perf_attr_* flags.
+  unsigned long long flags;
+  unsigned wakeup_events;
+  unsigned bp_type;
+  unsigned long long config1;
+};
+
+enum {
+  PERF_TYPE_HARDWARE = 0,
+  PERF_TYPE_SOFTWARE = 1,
+  PERF_TYPE_HW_CACHE = 3,
+};
+
+enum {
+  perf_attr_disabled = 1 << 0,
+  perf_attr_exclude_kernel = 1 << 5,
+  perf_attr_exclude_hv = 1 << 6,
+};
+
+#define PERF_EVENT_IOC_ENABLE 0x2400
+
+static int perf_event_open(struct perf_event_attr* attr, int pid, int cpu,
+                           int group_fd, unsigned long flags) {
+  return syscall5(SYS_perf_event_open, (long)attr, pid, cpu, group_fd, flags);
+}
+
+static int ioctl(int fd, unsigned long request, unsigned long arg) {
+  return syscall3(SYS_ioctl, fd, request, arg);
+}
+
+// The counters reported by util/trace.h in -DPERF_COUNTERS builds.
+enum perf_counter {
+  perf_cycles,
+  perf_instructions,
+  perf_llc_misses,
+  perf_dtlb_misses,
+  perf_branch_misses,
+  // A software event, which is available even without hardware counters.
+  perf_page_faults,
+  num_perf_counters,
+};
+
+static const char* const perf_counter_names[num_perf_counters] = {
+    "cpu-cycles",  "instructions",  "llc-misses",
+    "dtlb-misses", "branch-misses", "page-faults",
+};
+
+static const struct {
+  unsigned type;
+  unsigned config;
+} perf_counter_events[num_perf_counters] = {
+    {PERF_TYPE_HARDWARE, 0},  // PERF_COUNT_HW_CPU_CYCLES
+    {PERF_TYPE_HARDWARE, 1},  // PERF_COUNT_HW_INSTRUCTIONS
+    {PERF_TYPE_HARDWARE, 3},  // PERF_COUNT_HW_CACHE_MISSES
+    // PERF_COUNT_HW_CACHE_DTLB | PERF_COUNT_HW_CACHE_OP_READ << 8 |
+    // PERF_COUNT_HW_CACHE_RESULT_MISS << 16
+    {PERF_TYPE_HW_CACHE, 3 | 0 << 8 | 1 << 16},
+    {PERF_TYPE_HARDWARE, 5},  // PERF_COUNT_HW_BRANCH_MISSES
+    {PERF_TYPE_SOFTWARE, 2},  // PERF_COUNT_SW_PAGE_FAULTS
+};
+
+// File descriptors for the counters, or negative error codes for those which
+// could not be opened.
+static int perf_fds[num_perf_counters];
+
+// Open and start all of the counters.
+static void perf_counters_start(void) {
+  for (int i = 0; i < num_perf_counters; i++) {
+    struct perf_event_attr attr = {
+        .type = perf_counter_events[i].type,
+        .size = sizeof(attr),
+        .config = perf_counter_events[i].config,
+        .flags = perf_attr_disabled | perf_attr_exclude_kernel |
+                 perf_attr_exclude_hv,
+    };
+    perf_fds[i] = perf_event_open(&attr, 0, -1, -1, 0);
+  }
+  // Enable the counters together once they are all open, so that opening them
+  // isn't counted.
+  for (int i = 0; i < num_perf_counters; i++) {
+    if (perf_fds[i] >= 0) ioctl(perf_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+static bool perf_counter_available(enum perf_counter counter) {
+  return perf_fds[counter] >= 0;
+}
+
+// Read the current values of the counters. Unavailable counters read as 0.
+static void perf_counters_read(unsigned long long values[num_perf_counters]) {
+  for (int i = 0; i < num_perf_counters; i++) {
+    values[i] = 0;
+    if (perf_fds[i] >= 0) read(perf_fds[i], &values[i], sizeof(values[i]));
+  }
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "output.h"
+
 // Print an integer in decimal, followed by a newline.
 static void print_int(int x) {
   char buffer[16];
@@ -10,5 +12,5 @@ static void print_int(int x) {
     buffer[i] = '0' + (x % 10);
     x /= 10;
   } while (x);
-  write(STDOUT_FILENO, buffer + i, 16 - i);
+  output_write(buffer + i, 16 - i);
 }
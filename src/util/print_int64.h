@@ -1,19 +1,32 @@
 #pragma once
 
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+#include "format_int.h"
+#include "output.h"
+
+enum { max_int64_line = 21 };
+
 // Print an integer in decimal, followed by a newline.
 static void print_int64(unsigned long long x) {
-  // Use native BCD support to convert the number to decimal. This will only
-  // work for numbers smaller than 2^53, which is sufficient for all puzzles.
-  unsigned char bcd[10];
-  asm("fbstp %0" : "=m"(bcd) : "t"((double)x) : "st");
-  char buffer[19];
-  for (int i = 0; i < 9; i++) {
-    const unsigned char c = bcd[8 - i];
-    buffer[2 * i] = '0' + (c >> 4);
-    buffer[2 * i + 1] = '0' + (c & 0xF);
-  }
-  buffer[18] = '\n';
+  char* const o = format_u64(output_reserve(max_int64_line), x);
+  *o = '\n';
+  output_commit(o + 1);
+}
+
+// Print each of the given integers in decimal on its own line. The lines are
+// formatted straight into the output buffer, flushing only when it fills up.
+static void print_int64s(const unsigned long long* values, int count) {
   int i = 0;
-  while (i < 17 && buffer[i] == '0') i++;
-  write(STDOUT_FILENO, buffer + i, 19 - i);
+  while (i < count) {
+    char* o = output_reserve(max_int64_line);
+    const char* const limit =
+        output_buffer + output_buffer_size - max_int64_line;
+    for (; i < count && o <= limit; i++) {
+      o = format_u64(o, values[i]);
+      *o++ = '\n';
+    }
+    output_commit(o);
+  }
 }
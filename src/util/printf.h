@@ -3,45 +3,11 @@
 #ifndef PRINTF_H_
 #define PRINTF_H_
 
+#include "format_int.h"
 #include "memcpy.h"
+#include "output.h"
 #include "stdarg.h"
 
-// Format an unsigned integer to the given string, returning the first character
-// after the newly formatted integer.
-static char* putu(char* o, unsigned x) {
-  char buffer[16];
-  char* const end = buffer + sizeof(buffer);
-  char* i = end;
-  do {
-    *(--i) = '0' + (x % 10);
-    x /= 10;
-  } while (x);
-  while (i != end) *o++ = *i++;
-  return o;
-}
-
-// Print an integer in decimal, followed by a newline.
-static char* putu64(char* o, unsigned long long x) {
-  char buffer[24] = {0};
-  // Compute the decimal format one bit at a time by doubling and carrying BCD.
-  for (int i = 63; i >= 0; i--) {
-    for (int j = 0; j < 24; j++) buffer[j] *= 2;
-    if ((x >> i) & 1) buffer[23]++;
-    char carry = 0;
-    for (int j = 23; j >= 0; j--) {
-      char temp = buffer[j] + carry;
-      buffer[j] = temp % 10;
-      carry = temp / 10;
-    }
-  }
-  // Compute the most significant digit and truncate the output.
-  int i = 0;
-  while (buffer[i] == 0) i++;
-  const int start = i < 23 ? i : 23;
-  for (int j = start; j < 24; j++) *o++ = '0' + buffer[j];
-  return o;
-}
-
 // Format a string into the given buffer, returning the number of characters
 // that were written. This is a very crude subset of printf functionality.
 __attribute__((format(printf, 2, 0)))
@@ -60,10 +26,10 @@ static int vsprintf(char* buffer, const char* format, va_list args) {
       case 'l':
         if (*format++ != 'l') break;
         if (*format++ != 'u') break;
-        o = putu64(o, va_arg(args, unsigned long long));
+        o = format_u64(o, va_arg(args, unsigned long long));
         break;
       case 'u':
-        o = putu(o, va_arg(args, unsigned));
+        o = format_u32(o, va_arg(args, unsigned));
         break;
       case 's': {
         const char* s = va_arg(args, const char*);
@@ -92,7 +58,16 @@ static FILE* const stderr = &_stderr;
 
 __attribute__((format(printf, 2, 0)))
 static int vfprintf(FILE* f, const char* format, va_list args) {
-  char buffer[4096];
+  // Output to stdout is formatted directly into the output buffer. Any single
+  // call is assumed to produce less than 4096 bytes.
+  enum { max_length = 4096 };
+  if (f->fd == STDOUT_FILENO) {
+    char* const o = output_reserve(max_length);
+    const int length = vsprintf(o, format, args);
+    output_commit(o + length);
+    return length;
+  }
+  char buffer[max_length];
   const int length = vsprintf(buffer, format, args);
   return write(f->fd, buffer, length);
 }
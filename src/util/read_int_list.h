@@ -0,0 +1,103 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// Bulk parsing of integer lists. Instead of testing and converting one byte at
+// a time, numbers are located and converted a whole register at a time (four
+// digits on i386, eight on x86_64) with SWAR (SIMD within a register)
+// arithmetic. This reads up to a register's width beyond the end of each
+// number, so the input must be padded, as the buffers from map_input are.
+
+#include "die.h"
+
+// Registers are used rather than a fixed 64-bit word because on i386, 64-bit
+// arithmetic is split across register pairs and loses to read_int.
+typedef unsigned long read_int_word __attribute__((aligned(1), may_alias));
+enum { read_int_word_size = sizeof(read_int_word) };
+
+// Constants built from repeated bytes (e.g. 0x0101...) to fit the word size.
+static const unsigned long read_int_ones = (unsigned long)-1 / 0xFF;
+static const unsigned long read_int_pairs = (unsigned long)-1 / 0xFFFF * 0xFF;
+static const unsigned long read_int_quads =
+    (unsigned long)-1 / 0xFFFFFFFF * 0xFFFF;
+
+// Returns a mask with the top bit set in the first byte of `word` which is not
+// an ASCII digit and possibly in later bytes, which are garbage: a byte below
+// '0' borrows from the next byte when '0' is subtracted. A byte is a digit if
+// it doesn't go negative when '0' is subtracted or overflow 0x7F when 0x46
+// (0x7F - '9') is added to it.
+static unsigned long non_digit_mask(unsigned long word) {
+  return ((word - 0x30 * read_int_ones) | (word + 0x46 * read_int_ones) |
+          word) &
+         0x80 * read_int_ones;
+}
+
+// Convert the first n bytes of word, which must all be digits, to an integer.
+// The digits are shifted to the top of the word so that the unused bytes act as
+// leading zeros, and then adjacent lanes are combined pairwise: digits become
+// values below 100, then below 10000, and (on x86_64) then below 10^8.
+static unsigned swar_digits(unsigned long word, int n) {
+  word = (word & 0x0F * read_int_ones) << (8 * (read_int_word_size - n));
+  word = (word * 10 + (word >> 8)) & read_int_pairs;
+  word = (word * 100 + (word >> 16)) & read_int_quads;
+#if __SIZEOF_LONG__ == 8
+  word = word * 10000 + (word >> 32);
+#endif
+  return word;
+}
+
+static const unsigned read_int_powers[9] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+};
+
+// Append the integer `digits`, which has `power` as its scale, to `value`. An
+// integer which doesn't fit in 32 bits is an error rather than wrapping around.
+static unsigned read_int_append(unsigned value, unsigned power,
+                                unsigned digits) {
+  if (__builtin_mul_overflow(value, power, &value) ||
+      __builtin_add_overflow(value, digits, &value)) {
+    die("bad");
+  }
+  return value;
+}
+
+// Parse a list of decimal integers separated by `separator` into `values`,
+// which has space for `max_values` integers. Parsing stops at `end`, which must
+// come straight after a separator, or after the first integer which isn't
+// followed by a separator. Sets *count to the number of integers parsed and
+// returns the address of the first byte that was not consumed. As with
+// read_int, it is an error for an integer to be missing. Unlike read_int, it is
+// also an error for one to be 2^32 or more.
+static const char* read_int_list(const char* input, const char* end,
+                                 char separator, unsigned* values,
+                                 int max_values, int* count) {
+  int n = 0;
+  while (input != end) {
+    if (n == max_values) die("too many");
+    unsigned long word = *(const read_int_word*)input;
+    unsigned long mask = non_digit_mask(word);
+    if (mask & 0x80) die("bad");
+    unsigned value = 0;
+    // Numbers which fill whole words take a slower path.
+    while (mask == 0) {
+      value = read_int_append(value, read_int_powers[read_int_word_size],
+                              swar_digits(word, read_int_word_size));
+      input += read_int_word_size;
+      word = *(const read_int_word*)input;
+      mask = non_digit_mask(word);
+      if (mask & 0x80) break;
+    }
+    if (!(mask & 0x80)) {
+      const int digits = __builtin_ctzl(mask) >> 3;
+      value = read_int_append(value, read_int_powers[digits],
+                              swar_digits(word, digits));
+      input += digits;
+    }
+    values[n++] = value;
+    if (*input != separator) break;
+    input++;
+  }
+  *count = n;
+  return input;
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// Raw system calls for i386 and x86_64. On i386, the kernel is entered with
+// int $0x80 and arguments are passed in %ebx, %ecx, %edx, %esi, %edi and %ebp.
+// On x86_64, it is entered with the syscall instruction and arguments are
+// passed in %rdi, %rsi, %rdx, %r10, %r8 and %r9. In both cases, the call number
+// goes in the accumulator and the result comes back in it, with errors
+// returned as small negative values. The call numbers differ between the two.
+
+#ifdef __x86_64__
+
+#define SYS_read 0
+#define SYS_write 1
+#define SYS_open 2
+#define SYS_close 3
+#define SYS_fstat 5
+#define SYS_lseek 8
+#define SYS_mmap 9
+#define SYS_munmap 11
+#define SYS_brk 12
+#define SYS_ioctl 16
+#define SYS_sched_yield 24
+#define SYS_mremap 25
+#define SYS_mincore 27
+#define SYS_madvise 28
+#define SYS_dup 32
+#define SYS_dup2 33
+#define SYS_sendfile 40
+#define SYS_clone 56
+#define SYS_exit 60
+#define SYS_gettimeofday 96
+#define SYS_futex 202
+#define SYS_sched_getaffinity 204
+#define SYS_exit_group 231
+#define SYS_perf_event_open 298
+#define SYS_memfd_create 319
+
+static long syscall0(long n) {
+  long result;
+  asm volatile("syscall" : "=a"(result) : "a"(n) : "rcx", "r11", "memory");
+  return result;
+}
+
+static long syscall1(long n, long a) {
+  long result;
+  asm volatile("syscall"
+               : "=a"(result)
+               : "a"(n), "D"(a)
+               : "rcx", "r11", "memory");
+  return result;
+}
+
+static long syscall2(long n, long a, long b) {
+  long result;
+  asm volatile("syscall"
+               : "=a"(result)
+               : "a"(n), "D"(a), "S"(b)
+               : "rcx", "r11", "memory");
+  return result;
+}
+
+static long syscall3(long n, long a, long b, long c) {
+  long result;
+  asm volatile("syscall"
+               : "=a"(result)
+               : "a"(n), "D"(a), "S"(b), "d"(c)
+               : "rcx", "r11", "memory");
+  return result;
+}
+
+static long syscall4(long n, long a, long b, long c, long d) {
+  register long r10 asm("r10") = d;
+  long result;
+  asm volatile("syscall"
+               : "=a"(result)
+               : "a"(n), "D"(a), "S"(b), "d"(c), "r"(r10)
+               : "rcx", "r11", "memory");
+  return result;
+}
+
+static long syscall5(long n, long a, long b, long c, long d, long e) {
+  register long r10 asm("r10") = d;
+  register long r8 asm("r8") = e;
+  long result;
+  asm volatile("syscall"
+               : "=a"(result)
+               : "a"(n), "D"(a), "S"(b), "d"(c), "r"(r10), "r"(r8)
+               : "rcx", "r11", "memory");
+  return result;
+}
+
+static long syscall6(long n, long a, long b, long c, long d, long e, long f) {
+  register long r10 asm("r10") = d;
+  register long r8 asm("r8") = e;
+  register long r9 asm("r9") = f;
+  long result;
+  asm volatile("syscall"
+               : "=a"(result)
+               : "a"(n), "D"(a), "S"(b), "d"(c), "r"(r10), "r"(r8), "r"(r9)
+               : "rcx", "r11", "memory");
+  return result;
+}
+
+#else
+
+#define SYS_exit 1
+#define SYS_read 3
+#define SYS_write 4
+#define SYS_open 5
+#define SYS_close 6
+#define SYS_lseek 19
+#define SYS_dup 41
+#define SYS_brk 45
+#define SYS_ioctl 54
+#define SYS_dup2 63
+#define SYS_gettimeofday 78
+#define SYS_munmap 91
+#define SYS_clone 120
+#define SYS_sched_yield 158
+#define SYS_mremap 163
+#define SYS_sendfile 187
+#define SYS_mmap 192  // mmap2, which takes the offset in pages.
+#define SYS_fstat 197  // fstat64.
+#define SYS_mincore 218
+#define SYS_madvise 219
+#define SYS_futex 240
+#define SYS_sched_getaffinity 242
+#define SYS_exit_group 252
+#define SYS_perf_event_open 336
+#define SYS_memfd_create 356
+
+static long syscall0(long n) {
+  long result;
+  asm volatile("int $0x80" : "=a"(result) : "a"(n) : "memory");
+  return result;
+}
+
+static long syscall1(long n, long a) {
+  long result;
+  asm volatile("int $0x80" : "=a"(result) : "a"(n), "b"(a) : "memory");
+  return result;
+}
+
+static long syscall2(long n, long a, long b) {
+  long result;
+  asm volatile("int $0x80"
+               : "=a"(result)
+               : "a"(n), "b"(a), "c"(b)
+               : "memory");
+  return result;
+}
+
+static long syscall3(long n, long a, long b, long c) {
+  long result;
+  asm volatile("int $0x80"
+               : "=a"(result)
+               : "a"(n), "b"(a), "c"(b), "d"(c)
+               : "memory");
+  return result;
+}
+
+static long syscall4(long n, long a, long b, long c, long d) {
+  long result;
+  asm volatile("int $0x80"
+               : "=a"(result)
+               : "a"(n), "b"(a), "c"(b), "d"(c), "S"(d)
+               : "memory");
+  return result;
+}
+
+static long syscall5(long n, long a, long b, long c, long d, long e) {
+  long result;
+  asm volatile("int $0x80"
+               : "=a"(result)
+               : "a"(n), "b"(a), "c"(b), "d"(c), "S"(d), "D"(e)
+               : "memory");
+  return result;
+}
+
+// %ebp can't be named as an operand, so all six arguments are loaded from
+// memory inside the asm block instead.
+static long syscall6(long n, long a, long b, long c, long d, long e, long f) {
+  const long args[6] = {a, b, c, d, e, f};
+  const long* p = args;
+  long result;
+  asm volatile("push %%ebp\n"
+               "mov 20(%%ebx), %%ebp\n"
+               "mov 16(%%ebx), %%edi\n"
+               "mov 12(%%ebx), %%esi\n"
+               "mov 8(%%ebx), %%edx\n"
+               "mov 4(%%ebx), %%ecx\n"
+               "mov (%%ebx), %%ebx\n"
+               "int $0x80\n"
+               "pop %%ebp\n"
+               : "=a"(result), "+b"(p)
+               : "a"(n), "m"(args)
+               : "ecx", "edx", "esi", "edi", "memory");
+  return result;
+}
+
+#endif
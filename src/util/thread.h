@@ -0,0 +1,148 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// A minimal threading runtime built directly on clone and futex. Threads run on
+// stacks taken from a static arena and are never recycled, so a solver can
+// spawn at most max_threads threads over its lifetime.
+
+#include "die.h"
+
+// Atomic operations on ints. These are all sequentially consistent.
+static int atomic_load(const int* x) {
+  return __atomic_load_n(x, __ATOMIC_SEQ_CST);
+}
+
+static void atomic_store(int* x, int value) {
+  __atomic_store_n(x, value, __ATOMIC_SEQ_CST);
+}
+
+// Add to x, returning the previous value.
+static int atomic_fetch_add(int* x, int value) {
+  return __atomic_fetch_add(x, value, __ATOMIC_SEQ_CST);
+}
+
+// If *x == *expected, set *x = desired and return true. Otherwise, set
+// *expected = *x and return false.
+static bool atomic_compare_exchange(int* x, int* expected, int desired) {
+  return __atomic_compare_exchange_n(x, expected, desired, false,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static void atomic_fence(void) {
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+// Hint to the CPU that we are in a spin loop.
+static void cpu_relax(void) {
+  asm volatile("pause" ::: "memory");
+}
+
+// Give up the CPU to another runnable thread.
+static void thread_yield(void) {
+  syscall0(SYS_sched_yield);
+}
+
+#define FUTEX_WAIT 0
+#define FUTEX_WAKE 1
+
+// Sleep until woken, provided that *address == value.
+static int futex_wait(int* address, int value) {
+  return syscall4(SYS_futex, (long)address, FUTEX_WAIT, value, 0);
+}
+
+// Wake up to `count` threads which are waiting on the given address.
+static int futex_wake(int* address, int count) {
+  return syscall3(SYS_futex, (long)address, FUTEX_WAKE, count);
+}
+
+#define CLONE_VM 0x100
+#define CLONE_FS 0x200
+#define CLONE_FILES 0x400
+#define CLONE_SIGHAND 0x800
+#define CLONE_THREAD 0x10000
+#define CLONE_SYSVSEM 0x40000
+#define CLONE_PARENT_SETTID 0x100000
+#define CLONE_CHILD_CLEARTID 0x200000
+
+enum { max_threads = 16, thread_stack_size = 256 << 10 };
+static char thread_stacks[max_threads][thread_stack_size]
+    __attribute__((aligned(16)));
+static int num_threads;
+
+struct thread {
+  // The kernel thread ID while the thread is running, and 0 once it has
+  // exited. The kernel clears it and wakes any futex waiters on exit.
+  int tid;
+};
+
+// Start a new thread which runs fn(arg). The thread exits when fn returns.
+static void thread_spawn(struct thread* t, void (*fn)(void*), void* arg) {
+  if (num_threads == max_threads) die("too many threads");
+  char* const stack = thread_stacks[num_threads++];
+  enum {
+    flags = CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND | CLONE_THREAD |
+            CLONE_SYSVSEM | CLONE_PARENT_SETTID | CLONE_CHILD_CLEARTID,
+  };
+  long result;
+#ifdef __x86_64__
+  // The child starts with the stack pointer at `top`, which holds fn followed
+  // by arg. It pops both and calls fn(arg) with the stack 16-byte aligned.
+  void** const top = (void**)(stack + thread_stack_size) - 4;
+  top[0] = fn;
+  top[1] = arg;
+  // The kernel's argument order is flags, stack, parent_tid, child_tid, tls.
+  register long child_tid asm("r10") = (long)&t->tid;
+  register long tls asm("r8") = 0;
+  asm volatile("syscall\n"
+               "test %%rax, %%rax\n"
+               "jnz 1f\n"
+               // Child thread. Nothing from the parent's frame is valid here.
+               "pop %%rax\n"
+               "pop %%rdi\n"
+               "call *%%rax\n"
+               // Exit this thread only (not the whole thread group).
+               "mov %[exit], %%eax\n"
+               "xor %%edi, %%edi\n"
+               "syscall\n"
+               "1:\n"
+               : "=a"(result)
+               : "a"(SYS_clone), "D"(flags), "S"(top), "d"(&t->tid),
+                 "r"(child_tid), "r"(tls), [exit] "i"(SYS_exit)
+               : "rcx", "r11", "memory");
+#else
+  // The child starts with the stack pointer at `top`, which holds fn followed
+  // by arg. It pops fn and calls it, leaving the stack 16-byte aligned at the
+  // call with arg as the sole argument.
+  void** const top = (void**)(stack + thread_stack_size) - 5;
+  top[0] = fn;
+  top[1] = arg;
+  // The kernel's argument order is flags, stack, parent_tid, tls, child_tid.
+  asm volatile("int $0x80\n"
+               "test %%eax, %%eax\n"
+               "jnz 1f\n"
+               // Child thread. Nothing from the parent's frame is valid here.
+               "pop %%eax\n"
+               "call *%%eax\n"
+               // Exit this thread only (not the whole thread group).
+               "mov %[exit], %%eax\n"
+               "xor %%ebx, %%ebx\n"
+               "int $0x80\n"
+               "1:\n"
+               : "=a"(result)
+               : "a"(SYS_clone), "b"(flags), "c"(top), "d"(&t->tid), "S"(0),
+                 "D"(&t->tid), [exit] "i"(SYS_exit)
+               : "memory");
+#endif
+  if (result < 0) die("clone");
+}
+
+// Wait for a thread to exit.
+static void thread_join(struct thread* t) {
+  while (true) {
+    const int tid = atomic_load(&t->tid);
+    if (tid == 0) break;
+    futex_wait(&t->tid, tid);
+  }
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// Per-phase timing for solvers. TRACE_BEGIN(name) and TRACE_END() bracket a
+// phase of the solver (and may be nested). When built with -DTRACE, the time
+// stamp counter is read at each end of the phase, and on exit a line per phase
+// is written to stderr with its cycle count and the equivalent wall time. The
+// conversion is calibrated against gettimeofday over the whole traced run, so
+// it is only as precise as that run is long. Otherwise, the macros expand to
+// nothing.
+//
+// Building with -DPERF_COUNTERS implies -DTRACE and also reports the hardware
+// performance counters from util/perf_event.h for each phase. Counters which
+// can't be opened are listed once and left out of the per-phase lines.
+//
+// Solvers which allocate tables with util/huge_pages.h also get a line per
+// table, saying how much of it was touched.
+
+#ifdef TRACE
+
+#include "die.h"
+#include "gettimeofday.h"
+#include "printf.h"
+#ifdef PERF_COUNTERS
+#include "perf_event.h"
+#endif
+
+#define TRACE_BEGIN(name) trace_begin(name)
+#define TRACE_END() trace_end()
+
+enum { max_trace_phases = 32, max_trace_depth = 8 };
+
+struct trace_phase {
+  const char* name;
+  int depth;
+  unsigned long long cycles;
+#ifdef PERF_COUNTERS
+  unsigned long long counters[num_perf_counters];
+#endif
+};
+
+static struct {
+  struct trace_phase phases[max_trace_phases];
+  int num_phases;
+  // Indices of the phases which have begun but not yet ended.
+  int open[max_trace_depth];
+  int depth;
+  // The time at which the first phase began, for calibration.
+  unsigned long long start_cycles, start_us;
+} trace;
+
+// Read the time stamp counter. The fence stops it from being read before the
+// preceding instructions have completed.
+static unsigned long long trace_cycles(void) {
+  unsigned low, high;
+  asm volatile("lfence\n"
+               "rdtsc"
+               : "=a"(low), "=d"(high)
+               :
+               : "memory");
+  return (unsigned long long)high << 32 | low;
+}
+
+static unsigned long long trace_us(void) {
+  struct timeval t;
+  gettimeofday(&t, NULL);
+  return t.tv_sec * 1000000ULL + t.tv_usec;
+}
+
+static void trace_begin(const char* name) {
+  if (trace.num_phases == max_trace_phases) die("too many phases");
+  if (trace.depth == max_trace_depth) die("phases nested too deeply");
+  if (trace.num_phases == 0) {
+#ifdef PERF_COUNTERS
+    perf_counters_start();
+#endif
+    trace.start_us = trace_us();
+    trace.start_cycles = trace_cycles();
+  }
+  const int i = trace.num_phases++;
+  trace.open[trace.depth] = i;
+  trace.phases[i] = (struct trace_phase){.name = name, .depth = trace.depth};
+  trace.depth++;
+  // Read the counters last so that the bookkeeping isn't counted.
+#ifdef PERF_COUNTERS
+  perf_counters_read(trace.phases[i].counters);
+#endif
+  trace.phases[i].cycles = trace_cycles();
+}
+
+static void trace_end(void) {
+  const unsigned long long now = trace_cycles();
+#ifdef PERF_COUNTERS
+  unsigned long long counters[num_perf_counters];
+  perf_counters_read(counters);
+#endif
+  if (trace.depth == 0) die("no phase to end");
+  struct trace_phase* const phase = &trace.phases[trace.open[--trace.depth]];
+  phase->cycles = now - phase->cycles;
+#ifdef PERF_COUNTERS
+  for (int i = 0; i < num_perf_counters; i++) {
+    phase->counters[i] = counters[i] - phase->counters[i];
+  }
+#endif
+}
+
+// Defined by util/huge_pages.h if the solver uses it.
+__attribute__((weak)) void write_huge_pages_trace(void);
+
+// Write the report. This is not static so that exit() can find it via a weak
+// reference in the prelude. Phases which never ended (because the solver exited
+// early) are left out.
+void write_trace(void) {
+  if (trace.num_phases == 0) return;
+  const unsigned long long cycles = trace_cycles() - trace.start_cycles;
+  const unsigned long long us = trace_us() - trace.start_us;
+  // Cycles are converted to time in double precision, since dividing 64-bit
+  // integers would need __udivdi3 on i386.
+  const double us_per_cycle = cycles ? (double)us / cycles : 0;
+  fprintf(stderr, "trace: %u MHz\n",
+          us ? (unsigned)((double)cycles / us) : 0);
+#ifdef PERF_COUNTERS
+  for (int i = 0; i < num_perf_counters; i++) {
+    if (!perf_counter_available(i)) {
+      fprintf(stderr, "trace: %s unavailable\n", perf_counter_names[i]);
+    }
+  }
+#endif
+  for (int i = 0; i < trace.num_phases; i++) {
+    const struct trace_phase* const phase = &trace.phases[i];
+    bool open = false;
+    for (int j = 0; j < trace.depth; j++) open |= trace.open[j] == i;
+    if (open) continue;
+    static const char indent[] = "                ";
+    fprintf(stderr, "trace: %s%s %llu cycles, %u us",
+            indent + sizeof(indent) - 1 - 2 * phase->depth, phase->name,
+            phase->cycles, (unsigned)(phase->cycles * us_per_cycle));
+#ifdef PERF_COUNTERS
+    for (int j = 0; j < num_perf_counters; j++) {
+      if (!perf_counter_available(j)) continue;
+      fprintf(stderr, ", %llu %s", phase->counters[j], perf_counter_names[j]);
+    }
+#endif
+    fprintf(stderr, "\n");
+  }
+  if (write_huge_pages_trace) write_huge_pages_trace();
+}
+
+#else
+
+#define TRACE_BEGIN(name) ((void)0)
+#define TRACE_END() ((void)0)
+
+#endif
@@ -0,0 +1,83 @@
+#pragma once
+
+// Flag this header as a system header to avoid warnings for unused functions.
+#pragma GCC system_header
+
+// XXH64, a fast non-cryptographic hash, from the xxHash family. It only needs
+// 64-bit multiplication, which GCC expands inline even on i386. Chaining calls
+// through the seed hashes several pieces of data as one.
+
+static const unsigned long long xxh64_primes[5] = {
+    0x9E3779B185EBCA87ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL,
+    0x85EBCA77C2B2AE63ULL, 0x27D4EB2F165667C5ULL,
+};
+
+static unsigned long long xxh64_rotate(unsigned long long x, int n) {
+  return x << n | x >> (64 - n);
+}
+
+static unsigned long long xxh64_read64(const unsigned char* p) {
+  unsigned long long x;
+  __builtin_memcpy(&x, p, sizeof(x));
+  return x;
+}
+
+static unsigned xxh64_read32(const unsigned char* p) {
+  unsigned x;
+  __builtin_memcpy(&x, p, sizeof(x));
+  return x;
+}
+
+static unsigned long long xxh64_round(unsigned long long accumulator,
+                                      unsigned long long input) {
+  accumulator += input * xxh64_primes[1];
+  return xxh64_rotate(accumulator, 31) * xxh64_primes[0];
+}
+
+static unsigned long long xxh64_merge(unsigned long long hash,
+                                      unsigned long long accumulator) {
+  hash ^= xxh64_round(0, accumulator);
+  return hash * xxh64_primes[0] + xxh64_primes[3];
+}
+
+static unsigned long long xxh64(const void* data, size_t length,
+                                unsigned long long seed) {
+  const unsigned char* p = data;
+  const unsigned char* const end = p + length;
+  unsigned long long hash;
+  if (length >= 32) {
+    unsigned long long v[4] = {seed + xxh64_primes[0] + xxh64_primes[1],
+                               seed + xxh64_primes[1], seed,
+                               seed - xxh64_primes[0]};
+    do {
+      for (int i = 0; i < 4; i++, p += 8) {
+        v[i] = xxh64_round(v[i], xxh64_read64(p));
+      }
+    } while (end - p >= 32);
+    hash = xxh64_rotate(v[0], 1) + xxh64_rotate(v[1], 7) +
+           xxh64_rotate(v[2], 12) + xxh64_rotate(v[3], 18);
+    for (int i = 0; i < 4; i++) hash = xxh64_merge(hash, v[i]);
+  } else {
+    hash = seed + xxh64_primes[4];
+  }
+  hash += length;
+  for (; end - p >= 8; p += 8) {
+    hash ^= xxh64_round(0, xxh64_read64(p));
+    hash = xxh64_rotate(hash, 27) * xxh64_primes[0] + xxh64_primes[3];
+  }
+  if (end - p >= 4) {
+    hash ^= xxh64_read32(p) * xxh64_primes[0];
+    hash = xxh64_rotate(hash, 23) * xxh64_primes[1] + xxh64_primes[2];
+    p += 4;
+  }
+  for (; p != end; p++) {
+    hash ^= *p * xxh64_primes[4];
+    hash = xxh64_rotate(hash, 11) * xxh64_primes[0];
+  }
+  hash ^= hash >> 33;
+  hash *= xxh64_primes[1];
+  hash ^= hash >> 29;
+  hash *= xxh64_primes[2];
+  hash ^= hash >> 32;
+  return hash;
+}